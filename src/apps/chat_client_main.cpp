@@ -1,9 +1,15 @@
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <thread>
 #include <string>
+#include <unordered_map>
 
 #include "net/net_platform.h"
+#include "common/frame_decoder.h"
 #include "common/json_io.h"
+#include "common/zcodec.h"
 
 using jsonio::json;
 using net::socket_t;
@@ -29,6 +35,27 @@ static int prompt_int(const char* label, int def) {
   }
 }
 
+// --msgpack: hello 에서 v2 를 요청하고, 서버가 확정하면(hello_ok.enc) 이후 송신을 MessagePack 으로
+static bool g_want_msgpack = false;
+static std::atomic<bool> g_msgpack{false};
+
+// 입력 스레드와 수신 스레드(pong 응답)가 함께 보내므로 프레임 단위로 직렬화
+static std::mutex g_send_mx;
+
+static bool send_msg(socket_t s, const json& j) {
+  std::lock_guard<std::mutex> lk(g_send_mx);
+  return g_msgpack ? jsonio::send_msgpack(s, j) : jsonio::send_json(s, j);
+}
+
+// --compress: hello 에서 프레임 압축을 요청. 압축 프레임은 zlib 으로 풀어서 처리
+// 방 사전은 서버가 "dict" 메시지로 먼저 보내 줌 (수신 스레드만 접근)
+static bool g_want_compress = false;
+static std::unordered_map<uint32_t, zcodec::DictPtr> g_dicts;
+
+// history 커서 (수신 스레드가 갱신, 입력 스레드가 읽음)
+static std::atomic<uint64_t> g_history_before{0};
+static std::atomic<bool> g_history_done{false};
+
 static void print_incoming(const json& j) {
   std::string type = j.value("type", "");
   if (type == "chat") {
@@ -59,17 +86,78 @@ static void print_incoming(const json& j) {
     std::cout << "\n";
     return;
   }
+  if (type == "history_ok") {
+    // 다음 /history 는 이번에 받은 것보다 오래된 페이지
+    if (j.contains("before") && j["before"].is_number_unsigned())
+      g_history_before = j["before"].get<uint64_t>();
+    if (!j.value("more", false)) g_history_done = true;
+    std::cout << "* history [" << j.value("room","") << "]: " << j.value("count", 0) << " messages"
+              << (j.value("more", false) ? " (more: /history)" : "") << "\n";
+    return;
+  }
   if (type == "hello_ok") {
+    std::string enc = j.value("enc", "json");
+    if (enc == "msgpack") g_msgpack = true;
     std::cout << "* hello ok. nick=" << j.value("nick","")
-              << ", room=" << j.value("room","") << "\n";
+              << ", room=" << j.value("room","")
+              << (g_want_msgpack ? ", encoding=" + enc : "")
+              << (g_want_compress ? ", compress=" + j.value("compress", "none") : "") << "\n";
+    return;
+  }
+  if (type == "batch") {
+    // 서버가 여러 chat 을 프레임 하나로 묶어 보냄 (hello 의 "batch":true)
+    if (j.contains("items") && j["items"].is_array()) {
+      for (const auto& item : j["items"]) print_incoming(item);
+    }
+    return;
+  }
+  if (type == "batch_ok") {
+    if (j.value("failed", 0) == 0) return;
+    for (const auto& r : j.value("results", json::array())) {
+      if (r.value("ok", true)) continue;
+      std::cout << "! batch item " << r.value("i", 0) << " (" << r.value("code","") << "): "
+                << r.value("text","") << "\n";
+    }
+    return;
+  }
+  if (type == "dict") {
+    auto d = zcodec::Dict::make(j.value("data", ""));
+    if (d->id != j.value("id", 0u)) {
+      std::cout << "! dict id mismatch for [" << j.value("room","") << "]\n";
+      return;
+    }
+    g_dicts[d->id] = d;
+    std::cout << "* compression dict for [" << j.value("room","") << "]: "
+              << d->bytes.size() << " bytes\n";
     return;
   }
   std::cout << j.dump() << "\n";
 }
 
+static bool recv_incoming(socket_t s, json& out) {
+  std::string payload;
+  bool compressed = false;
+  if (!framing::recv_message(s, payload, compressed)) return false;
+  if (compressed) {
+    std::string raw;
+    auto lookup = [](uint32_t id) -> const zcodec::Dict* {
+      auto it = g_dicts.find(id);
+      return it == g_dicts.end() ? nullptr : it->second.get();
+    };
+    if (!zcodec::inflate(payload, lookup, framing::kMaxFrameSize, raw)) return false;
+    payload.swap(raw);
+  }
+  return jsonio::parse_any(payload, out);
+}
+
 static void recv_loop(socket_t s) {
   json j;
-  while (jsonio::recv_json(s, j)) {
+  while (recv_incoming(s, j)) {
+    // 서버 keepalive: 조용히 답만 함
+    if (j.value("type", "") == "ping") {
+      send_msg(s, json{{"v",1},{"type","pong"}});
+      continue;
+    }
     std::cout << "\n";
     print_incoming(j);
     std::cout << "> " << std::flush;
@@ -77,7 +165,18 @@ static void recv_loop(socket_t s) {
   std::cout << "\n[disconnected]\n";
 }
 
-int main() {
+int main(int argc, char** argv) {
+  // usage: chat_client [--msgpack] [--compress]
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--msgpack") g_want_msgpack = true;
+    else if (a == "--compress") g_want_compress = true;
+    else {
+      std::cerr << "unknown option: " << a << "\n";
+      return 1;
+    }
+  }
+
   std::string ip = prompt_line("Server IP", "127.0.0.1");
   int port = prompt_int("Port", 9000);
   std::string nick = prompt_line("Nickname");
@@ -114,22 +213,41 @@ int main() {
   std::thread t(recv_loop, s);
 
   // hello
-  jsonio::send_json(s, json{{"v",1},{"type","hello"},{"nick",nick},{"req_id","h1"}});
+  json hello = {{"v",1},{"type","hello"},{"nick",nick},{"batch",true},{"req_id","h1"}};
+  if (g_want_msgpack) {
+    hello["v"] = 2;
+    hello["enc"] = "msgpack";
+  }
+  if (g_want_compress && zcodec::supported()) hello["compress"] = "deflate";
+  {
+    std::lock_guard<std::mutex> lk(g_send_mx);
+    jsonio::send_json(s, hello);
+  }
 
-  std::cout << "Commands: /who, /join <room>, /nick <new>, /quit\n> ";
+  std::cout << "Commands: /who, /join <room>, /nick <new>, /history, /quit\n> ";
   std::string line;
   while (std::getline(std::cin, line)) {
     if (line == "/quit") break;
 
     if (!line.empty() && line[0] == '/') {
       if (line == "/who") {
-        jsonio::send_json(s, json{{"v",1},{"type","who"},{"req_id","w1"}});
+        send_msg(s, json{{"v",1},{"type","who"},{"req_id","w1"}});
+      } else if (line == "/history") {
+        json req = {{"v",1},{"type","history"},{"req_id","hi1"}};
+        if (g_history_done) {
+          std::cout << "* no older messages\n> ";
+          continue;
+        }
+        if (g_history_before) req["before"] = g_history_before.load();
+        send_msg(s, req);
       } else if (line.rfind("/join ", 0) == 0) {
+        g_history_before = 0;
+        g_history_done = false;
         std::string room = line.substr(6);
-        jsonio::send_json(s, json{{"v",1},{"type","join"},{"room",room},{"req_id","j1"}});
+        send_msg(s, json{{"v",1},{"type","join"},{"room",room},{"req_id","j1"}});
       } else if (line.rfind("/nick ", 0) == 0) {
         std::string nn = line.substr(6);
-        jsonio::send_json(s, json{{"v",1},{"type","nick"},{"nick",nn},{"req_id","n1"}});
+        send_msg(s, json{{"v",1},{"type","nick"},{"nick",nn},{"req_id","n1"}});
       } else {
         std::cout << "! unknown command\n";
       }
@@ -138,7 +256,7 @@ int main() {
     }
 
     if (!line.empty()) {
-      jsonio::send_json(s, json{{"v",1},{"type","chat"},{"text",line}});
+      send_msg(s, json{{"v",1},{"type","chat"},{"text",line}});
     }
     std::cout << "> ";
   }
@@ -4,16 +4,37 @@
 #include "transport/gateway/ws_gateway.h"
 
 int main(int argc, char** argv) {
-  // usage: chat_gateway <ws_port> <tcp_host> <tcp_port>
+  // usage: chat_gateway <ws_port> <tcp_host> <tcp_mux_port> [--links N] [--io-threads N]
+  //                     [--backend-max-bytes N] [--client-max-bytes N]
+  //   tcp_mux_port = chatd_tcp --mux-port
   int ws_port = 9001;
   std::string tcp_host = "127.0.0.1";
-  int tcp_port = 9000;
+  int tcp_port = 9100;
+  transport::gateway::WsGatewayOptions opt;
 
-  if (argc >= 2) ws_port = std::stoi(argv[1]);
-  if (argc >= 3) tcp_host = argv[2];
-  if (argc >= 4) tcp_port = std::stoi(argv[3]);
+  int pos = 0;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--links" && i + 1 < argc) {
+      opt.links = std::stoi(argv[++i]);
+    } else if (a == "--io-threads" && i + 1 < argc) {
+      opt.io_threads = std::stoi(argv[++i]);
+    } else if (a == "--backend-max-bytes" && i + 1 < argc) {
+      opt.backend_max_bytes = std::stoull(argv[++i]);
+    } else if (a == "--client-max-bytes" && i + 1 < argc) {
+      opt.client_max_bytes = std::stoull(argv[++i]);
+    } else if (pos == 0) {
+      ws_port = std::stoi(a);
+      pos++;
+    } else if (pos == 1) {
+      tcp_host = a;
+      pos++;
+    } else {
+      tcp_port = std::stoi(a);
+    }
+  }
 
-  transport::gateway::WsGateway gw(tcp_host, tcp_port);
+  transport::gateway::WsGateway gw(tcp_host, tcp_port, opt);
   if (!gw.start(ws_port)) {
     std::cerr << "failed to start gateway\n";
     return 1;
@@ -24,5 +45,10 @@ int main(int argc, char** argv) {
   std::getline(std::cin, tmp);
 
   gw.stop();
+  const auto& st = gw.stats();
+  std::cout << "gateway: to_backend=" << st.to_backend
+            << " to_clients=" << st.to_clients
+            << " read_pauses=" << st.read_pauses
+            << " evicted=" << st.evicted << "\n";
   return 0;
 }
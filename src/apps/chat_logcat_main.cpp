@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/binlog_format.h"
+#include "core/logger.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 바이너리 채팅 로그(chatd_tcp --log-format binary) 조회 도구
+// - 파일을 mmap 하고, 푸터가 있으면 인덱스 체인만 따라가 조건에 맞는 블록만 디코드
+// - 푸터가 없으면(비정상 종료) 레코드 길이만 따라가며 한 번 훑음
+namespace {
+
+// 읽기 전용 매핑 (Windows 는 통째로 읽음)
+class MappedFile {
+public:
+  ~MappedFile() {
+#ifndef _WIN32
+    if (map_ && map_ != MAP_FAILED) ::munmap(map_, size_);
+#endif
+  }
+
+  bool open(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    map_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map_ == MAP_FAILED) return false;
+    data_ = static_cast<const uint8_t*>(map_);
+    return true;
+#else
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) return false;
+    buf_.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    data_ = reinterpret_cast<const uint8_t*>(buf_.data());
+    size_ = buf_.size();
+    return size_ > 0;
+#endif
+  }
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+#ifndef _WIN32
+  void* map_ = nullptr;
+#else
+  std::string buf_;
+#endif
+};
+
+struct Block {
+  size_t off = 0;
+  size_t len = 0;
+  uint64_t ts_min = 0;
+  uint64_t ts_max = 0;
+  std::vector<uint32_t> rooms;
+  std::vector<uint32_t> nicks;
+};
+
+struct Filter {
+  std::string room, nick;
+  bool has_room = false, has_nick = false;
+  uint32_t room_id = 0, nick_id = 0; // 사전에서 찾은 id (0 = 아직 없음)
+  uint32_t kind = 0;                 // 0 = 전부
+  uint64_t since = 0;                // base 기준 상대 us
+  uint64_t until = UINT64_MAX;
+};
+
+struct Reader {
+  const uint8_t* base = nullptr;
+  size_t size = 0;
+  int64_t base_unix_us = 0;
+  std::vector<std::string> rooms{""}, nicks{""}; // id -> 이름 (0 = 없음)
+  Filter f;
+  std::string out;
+  uint64_t matched = 0;
+
+  void define(uint32_t kind, uint64_t id, std::string name) {
+    auto& dict = kind == binlog::kDefRoom ? rooms : nicks;
+    if (id >= dict.size()) dict.resize(id + 1);
+    if (kind == binlog::kDefRoom && f.has_room && name == f.room) f.room_id = static_cast<uint32_t>(id);
+    if (kind == binlog::kDefNick && f.has_nick && name == f.nick) f.nick_id = static_cast<uint32_t>(id);
+    dict[id] = std::move(name);
+  }
+
+  const std::string& name_of(const std::vector<std::string>& dict, uint64_t id) const {
+    return id < dict.size() ? dict[id] : dict[0];
+  }
+
+  void emit(uint32_t kind, uint64_t ts, uint64_t room, uint64_t nick, std::string_view text) {
+    int64_t abs_us = base_unix_us + static_cast<int64_t>(ts);
+    std::time_t t = static_cast<std::time_t>(abs_us / 1000000);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    char b[40];
+    size_t n = std::strftime(b, sizeof(b), "[%Y-%m-%d %H:%M:%S", &tm);
+    std::snprintf(b + n, sizeof(b) - n, ".%03d] ", static_cast<int>((abs_us / 1000) % 1000));
+    out += b;
+
+    core::LogRecord r;
+    r.ev = static_cast<core::LogEvent>(kind);
+    r.room = name_of(rooms, room);
+    r.nick = name_of(nicks, nick);
+    r.text = text;
+    core::append_log_line(out, r);
+    out += '\n';
+    matched++;
+    if (out.size() >= 64 * 1024) flush();
+  }
+
+  void flush() {
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    out.clear();
+  }
+
+  bool match(uint32_t kind, uint64_t ts, uint64_t room, uint64_t nick) const {
+    if (f.kind && kind != f.kind) return false;
+    if (ts < f.since || ts > f.until) return false;
+    if (f.has_room && (f.room_id == 0 || room != f.room_id)) return false;
+    if (f.has_nick && (f.nick_id == 0 || nick != f.nick_id)) return false;
+    return true;
+  }
+
+  // [from, to) 구간의 레코드를 순서대로 처리. 잘린 레코드를 만나면 멈춤
+  void scan(size_t from, size_t to) {
+    const uint8_t* p = base + from;
+    const uint8_t* end = base + to;
+    while (p < end) {
+      uint64_t len;
+      if (!binlog::get_varint(p, end, len) || len > static_cast<uint64_t>(end - p)) return;
+      const uint8_t* body = p;
+      const uint8_t* bend = p + len;
+      p = bend;
+
+      uint64_t kind;
+      if (!binlog::get_varint(body, bend, kind)) return;
+
+      if (kind == binlog::kDefRoom || kind == binlog::kDefNick) {
+        uint64_t id;
+        if (!binlog::get_varint(body, bend, id)) return;
+        define(static_cast<uint32_t>(kind), id,
+               std::string(reinterpret_cast<const char*>(body), bend - body));
+        continue;
+      }
+      if (kind < binlog::kConnect || kind > binlog::kChat) continue; // 인덱스 등
+
+      uint64_t ts, room, nick;
+      if (!binlog::get_varint(body, bend, ts) || !binlog::get_varint(body, bend, room) ||
+          !binlog::get_varint(body, bend, nick)) return;
+      if (!match(static_cast<uint32_t>(kind), ts, room, nick)) continue;
+      emit(static_cast<uint32_t>(kind), ts, room, nick,
+           std::string_view(reinterpret_cast<const char*>(body), bend - body));
+    }
+  }
+
+  // off 의 레코드를 인덱스로 해석
+  bool read_index(size_t off, Block& b, size_t& prev) {
+    const uint8_t* p = base + off;
+    const uint8_t* end = base + size;
+    uint64_t len, kind;
+    if (!binlog::get_varint(p, end, len) || len > static_cast<uint64_t>(end - p)) return false;
+    end = p + len;
+    if (!binlog::get_varint(p, end, kind) || kind != binlog::kIndex) return false;
+
+    uint64_t v[6];
+    for (auto& x : v) if (!binlog::get_varint(p, end, x)) return false;
+    prev = static_cast<size_t>(v[0]);
+    b.off = static_cast<size_t>(v[1]);
+    b.len = static_cast<size_t>(v[2]);
+    b.ts_min = v[4];
+    b.ts_max = v[5];
+    if (b.off > size || b.len > size - b.off) return false;
+
+    for (auto* ids : {&b.rooms, &b.nicks}) {
+      uint64_t n, id;
+      if (!binlog::get_varint(p, end, n)) return false;
+      for (uint64_t i = 0; i < n; i++) {
+        if (!binlog::get_varint(p, end, id)) return false;
+        ids->push_back(static_cast<uint32_t>(id));
+      }
+    }
+
+    uint64_t ndefs;
+    if (!binlog::get_varint(p, end, ndefs)) return false;
+    for (uint64_t i = 0; i < ndefs; i++) {
+      uint64_t dk, id, nl;
+      if (!binlog::get_varint(p, end, dk) || !binlog::get_varint(p, end, id) ||
+          !binlog::get_varint(p, end, nl) || nl > static_cast<uint64_t>(end - p)) return false;
+      define(static_cast<uint32_t>(dk), id, std::string(reinterpret_cast<const char*>(p), nl));
+      p += nl;
+    }
+    return true;
+  }
+
+  // 푸터 -> 인덱스 체인. 실패하면 false (호출자가 전체 스캔)
+  bool load_blocks(std::vector<Block>& blocks) {
+    if (size < binlog::kHeaderSize + binlog::kFooterSize) return false;
+    const uint8_t* foot = base + size - binlog::kFooterSize;
+    if (std::memcmp(foot + 8, binlog::kFooterMagic, 8) != 0) return false;
+
+    size_t off = static_cast<size_t>(binlog::get_u64le(foot));
+    while (off != 0) {
+      if (off < binlog::kHeaderSize || off >= size) return false;
+      Block b;
+      size_t prev = 0;
+      if (!read_index(off, b, prev) || (prev != 0 && prev >= off)) return false;
+      blocks.push_back(std::move(b));
+      off = prev;
+    }
+    std::reverse(blocks.begin(), blocks.end());
+    return true;
+  }
+
+  bool block_matches(const Block& b) const {
+    if (b.ts_max < f.since || b.ts_min > f.until) return false;
+    auto has = [](const std::vector<uint32_t>& v, uint32_t id) {
+      return std::find(v.begin(), v.end(), id) != v.end();
+    };
+    if (f.has_room && (f.room_id == 0 || !has(b.rooms, f.room_id))) return false;
+    if (f.has_nick && (f.nick_id == 0 || !has(b.nicks, f.nick_id))) return false;
+    return true;
+  }
+};
+
+// "1700000000" (unix 초) 또는 "HH:MM[:SS]" (파일 날짜 기준 현지 시각)
+bool parse_time(const std::string& s, int64_t base_unix_us, int64_t& out_us) {
+  int h = 0, m = 0, sec = 0;
+  if (s.find(':') != std::string::npos) {
+    if (std::sscanf(s.c_str(), "%d:%d:%d", &h, &m, &sec) < 2) return false;
+    std::time_t t = static_cast<std::time_t>(base_unix_us / 1000000);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    tm.tm_hour = h;
+    tm.tm_min = m;
+    tm.tm_sec = sec;
+    out_us = static_cast<int64_t>(std::mktime(&tm)) * 1000000;
+    return true;
+  }
+  char* end = nullptr;
+  long long v = std::strtoll(s.c_str(), &end, 10);
+  if (!end || *end) return false;
+  out_us = static_cast<int64_t>(v) * 1000000;
+  return true;
+}
+
+uint64_t to_rel(int64_t abs_us, int64_t base_us) {
+  return abs_us <= base_us ? 0 : static_cast<uint64_t>(abs_us - base_us);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  // usage: chat_logcat <file.bin> [--room R] [--nick N]
+  //                    [--type chat|system|connect|disconnect]
+  //                    [--since T] [--until T] [--stats]
+  //        T = unix 초 또는 HH:MM[:SS] (파일 날짜의 현지 시각)
+  std::string path, since_s, until_s;
+  Reader rd;
+  bool stats = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--room" && i + 1 < argc) {
+      rd.f.room = argv[++i];
+      rd.f.has_room = true;
+    } else if (a == "--nick" && i + 1 < argc) {
+      rd.f.nick = argv[++i];
+      rd.f.has_nick = true;
+    } else if (a == "--type" && i + 1 < argc) {
+      std::string t = argv[++i];
+      if (t == "connect") rd.f.kind = binlog::kConnect;
+      else if (t == "disconnect") rd.f.kind = binlog::kDisconnect;
+      else if (t == "system") rd.f.kind = binlog::kSystem;
+      else if (t == "chat") rd.f.kind = binlog::kChat;
+      else {
+        std::cerr << "unknown type: " << t << "\n";
+        return 1;
+      }
+    } else if (a == "--since" && i + 1 < argc) {
+      since_s = argv[++i];
+    } else if (a == "--until" && i + 1 < argc) {
+      until_s = argv[++i];
+    } else if (a == "--stats") {
+      stats = true;
+    } else if (path.empty()) {
+      path = a;
+    } else {
+      std::cerr << "unexpected argument: " << a << "\n";
+      return 1;
+    }
+  }
+
+  if (path.empty()) {
+    std::cerr << "usage: chat_logcat <file.bin> [--room R] [--nick N] [--type T]"
+                 " [--since T] [--until T] [--stats]\n";
+    return 1;
+  }
+
+  MappedFile mf;
+  if (!mf.open(path)) {
+    std::cerr << "cannot open " << path << "\n";
+    return 1;
+  }
+  if (mf.size() < binlog::kHeaderSize || std::memcmp(mf.data(), binlog::kMagic, 8) != 0) {
+    std::cerr << path << ": not a chat binary log\n";
+    return 1;
+  }
+
+  rd.base = mf.data();
+  rd.size = mf.size();
+  rd.base_unix_us = static_cast<int64_t>(binlog::get_u64le(mf.data() + 8));
+
+  int64_t t;
+  if (!since_s.empty()) {
+    if (!parse_time(since_s, rd.base_unix_us, t)) {
+      std::cerr << "bad --since: " << since_s << "\n";
+      return 1;
+    }
+    rd.f.since = to_rel(t, rd.base_unix_us);
+  }
+  if (!until_s.empty()) {
+    if (!parse_time(until_s, rd.base_unix_us, t)) {
+      std::cerr << "bad --until: " << until_s << "\n";
+      return 1;
+    }
+    rd.f.until = to_rel(t, rd.base_unix_us);
+  }
+
+  std::vector<Block> blocks;
+  size_t scanned = 0;
+  bool indexed = rd.load_blocks(blocks);
+  if (indexed) {
+    for (const Block& b : blocks) {
+      if (!rd.block_matches(b)) continue;
+      rd.scan(b.off, b.off + b.len);
+      scanned++;
+    }
+  } else {
+    // 정상 종료되지 않은 파일: 처음부터 끝까지 (id 사전도 진행하며 채움)
+    blocks.clear();
+    rd.scan(binlog::kHeaderSize, rd.size);
+  }
+  rd.flush();
+
+  if (stats) {
+    std::cerr << "index=" << (indexed ? "yes" : "no (linear scan)")
+              << " blocks=" << blocks.size() << " scanned=" << scanned
+              << " matched=" << rd.matched << "\n";
+  }
+  return 0;
+}
@@ -1,58 +1,237 @@
 #include <iostream>
-#include <fstream>
-#include <filesystem>
-#include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <string>
 
+#include "core/async_logger.h"
 #include "core/chat_core.h"
+#include "core/segment_store.h"
+#include "transport/tcp/mux_server.h"
 #include "transport/tcp/tcp_server.h"
-
-static std::string today_yyyymmdd() {
-  using namespace std::chrono;
-  auto now = system_clock::now();
-  std::time_t t = system_clock::to_time_t(now);
-  std::tm tm{};
-#ifdef _WIN32
-  localtime_s(&tm, &t);
-#else
-  tm = *std::localtime(&t);
+#ifdef CHAT_HAS_URING
+#include "transport/uring/uring_server.h"
 #endif
-  std::ostringstream oss;
-  oss << std::put_time(&tm, "%Y%m%d");
-  return oss.str();
+
+static void print_outbound_stats(const core::OutboundStats& st, const char* label = "outbound") {
+  std::cout << label << ": queued=" << st.queued
+            << " dropped_oldest=" << st.dropped_oldest
+            << " dropped_chat=" << st.dropped_chat
+            << " dropped_new=" << st.dropped_new
+            << " disconnected=" << st.disconnected
+            << " peak_bytes=" << st.peak_bytes << "\n";
 }
 
-static std::string now_hhmmss() {
-  using namespace std::chrono;
-  auto now = system_clock::now();
-  std::time_t t = system_clock::to_time_t(now);
-  std::tm tm{};
-#ifdef _WIN32
-  localtime_s(&tm, &t);
-#else
-  tm = *std::localtime(&t);
-#endif
-  std::ostringstream oss;
-  oss << std::put_time(&tm, "%H:%M:%S");
-  return oss.str();
+static void print_log_stats(const core::AsyncLogger& lg) {
+  std::cout << "log: written=" << lg.written()
+            << " dropped=" << lg.dropped()
+            << " rotations=" << lg.rotations() << "\n";
+}
+
+static void print_store_stats(const core::SegmentStore* st) {
+  if (!st) return;
+  const auto& s = st->stats();
+  std::cout << "history store: appended=" << s.appended
+            << " flushed_bytes=" << s.flushed_bytes
+            << " segments_created=" << s.segments_created
+            << " segments_retired=" << s.segments_retired
+            << " truncated_tails=" << s.truncated_tails
+            << " io_errors=" << s.io_errors << "\n";
+}
+
+static void print_compress_stats(const core::ChatCore& c, bool enabled) {
+  if (!enabled) return;
+  const auto& s = c.compress_stats();
+  std::cout << "compress: frames=" << s.frames
+            << " raw_bytes=" << s.raw_bytes
+            << " wire_bytes=" << s.wire_bytes
+            << " ratio=" << s.ratio()
+            << " skipped=" << s.skipped
+            << " dicts=" << s.dicts << "\n";
+}
+
+static void print_keepalive_stats(const core::Keepalive* k) {
+  if (!k) return;
+  const auto& s = k->stats();
+  std::cout << "keepalive: pings=" << s.pings << " evicted=" << s.evicted << "\n";
 }
 
 int main(int argc, char** argv) {
+  // usage: chatd_tcp [port] [--mode reactor|threaded|sharded|uring] [--io-threads N]
+  //                  [--backlog N] [--pin-cpus] [--cork-us N]
+  //                  [--slow-policy disconnect|drop-oldest|drop-chat]
+  //                  [--out-max-bytes N] [--out-max-msgs N]
+  //                  [--log-max-bytes N] [--log-fsync never|batch|interval]
+  //                  [--log-format text|binary]
+  //                  [--history-msgs N] [--history-bytes N] [--history-global-bytes N]
+  //                  [--history-replay N]
+  //                  [--history-dir DIR] [--history-segment-bytes N]
+  //                  [--history-max-segments N] [--history-max-age SEC]
+  //                  [--compress] [--compress-min N] [--compress-level N]
+  //                  [--compress-room-dict]
+  //                  [--keepalive SEC] [--keepalive-timeout SEC]
+  //                  [--mux-port N]
   int port = 9000;
-  if (argc >= 2) port = std::stoi(argv[1]);
+  int mux_port = 0;
+  transport::tcp::TcpServerOptions opt;
+  core::AsyncLoggerOptions lopt;
+  core::HistoryLimits hist;
+  core::SegmentStoreOptions sopt;
+  core::CompressOptions zopt;
+  core::KeepaliveOptions kopt;
+  bool keepalive = false;
+  bool persist = false;
+  bool use_uring = false;
 
-  std::filesystem::create_directories("logs");
-  std::string logpath = "logs/chat_" + today_yyyymmdd() + ".txt";
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--mode" && i + 1 < argc) {
+      std::string m = argv[++i];
+      if (m == "reactor") opt.mode = transport::tcp::TcpMode::Reactor;
+      else if (m == "sharded") opt.mode = transport::tcp::TcpMode::Sharded;
+      else if (m == "threaded") opt.mode = transport::tcp::TcpMode::Threaded;
+      else if (m == "uring") use_uring = true;
+      else {
+        std::cerr << "unknown mode: " << m << "\n";
+        return 1;
+      }
+    } else if (a == "--io-threads" && i + 1 < argc) {
+      opt.io_threads = std::stoi(argv[++i]);
+    } else if (a == "--backlog" && i + 1 < argc) {
+      opt.backlog = std::stoi(argv[++i]);
+    } else if (a == "--cork-us" && i + 1 < argc) {
+      opt.cork_us = static_cast<unsigned>(std::stoul(argv[++i]));
+    } else if (a == "--slow-policy" && i + 1 < argc) {
+      std::string p = argv[++i];
+      if (p == "disconnect") opt.outbound.policy = core::SlowConsumerPolicy::Disconnect;
+      else if (p == "drop-oldest") opt.outbound.policy = core::SlowConsumerPolicy::DropOldest;
+      else if (p == "drop-chat") opt.outbound.policy = core::SlowConsumerPolicy::DropChat;
+      else {
+        std::cerr << "unknown slow-consumer policy: " << p << "\n";
+        return 1;
+      }
+    } else if (a == "--out-max-bytes" && i + 1 < argc) {
+      opt.outbound.max_bytes = std::stoull(argv[++i]);
+    } else if (a == "--out-max-msgs" && i + 1 < argc) {
+      opt.outbound.max_msgs = std::stoull(argv[++i]);
+    } else if (a == "--log-max-bytes" && i + 1 < argc) {
+      lopt.max_file_bytes = std::stoull(argv[++i]);
+    } else if (a == "--log-fsync" && i + 1 < argc) {
+      std::string f = argv[++i];
+      if (f == "never") lopt.fsync = core::FsyncPolicy::Never;
+      else if (f == "batch") lopt.fsync = core::FsyncPolicy::EveryBatch;
+      else if (f == "interval") lopt.fsync = core::FsyncPolicy::Interval;
+      else {
+        std::cerr << "unknown fsync policy: " << f << "\n";
+        return 1;
+      }
+    } else if (a == "--log-format" && i + 1 < argc) {
+      std::string f = argv[++i];
+      if (f == "text") lopt.format = core::LogFormat::Text;
+      else if (f == "binary") lopt.format = core::LogFormat::Binary;
+      else {
+        std::cerr << "unknown log format: " << f << "\n";
+        return 1;
+      }
+    } else if (a == "--history-msgs" && i + 1 < argc) {
+      hist.max_msgs = std::stoull(argv[++i]);
+    } else if (a == "--history-bytes" && i + 1 < argc) {
+      hist.max_bytes = std::stoull(argv[++i]);
+    } else if (a == "--history-global-bytes" && i + 1 < argc) {
+      hist.global_max_bytes = std::stoull(argv[++i]);
+    } else if (a == "--history-replay" && i + 1 < argc) {
+      hist.replay_msgs = std::stoull(argv[++i]);
+    } else if (a == "--history-dir" && i + 1 < argc) {
+      sopt.dir = argv[++i];
+      persist = true;
+    } else if (a == "--history-segment-bytes" && i + 1 < argc) {
+      sopt.segment_bytes = std::stoull(argv[++i]);
+    } else if (a == "--history-max-segments" && i + 1 < argc) {
+      sopt.max_segments = std::stoull(argv[++i]);
+    } else if (a == "--history-max-age" && i + 1 < argc) {
+      sopt.max_age_sec = std::stoull(argv[++i]);
+    } else if (a == "--compress") {
+      zopt.enabled = true;
+    } else if (a == "--compress-min" && i + 1 < argc) {
+      zopt.min_bytes = std::stoull(argv[++i]);
+    } else if (a == "--compress-level" && i + 1 < argc) {
+      zopt.level = std::stoi(argv[++i]);
+    } else if (a == "--compress-room-dict") {
+      zopt.room_dict = true;
+    } else if (a == "--keepalive" && i + 1 < argc) {
+      kopt.idle_ms = static_cast<uint32_t>(std::stoul(argv[++i]) * 1000);
+      keepalive = true;
+    } else if (a == "--keepalive-timeout" && i + 1 < argc) {
+      kopt.timeout_ms = static_cast<uint32_t>(std::stoul(argv[++i]) * 1000);
+    } else if (a == "--mux-port" && i + 1 < argc) {
+      mux_port = std::stoi(argv[++i]);
+    } else if (a == "--pin-cpus") {
+      opt.pin_cpus = true;
+    } else {
+      port = std::stoi(a);
+    }
+  }
 
-  auto logger = [logpath](const std::string& line) {
-    std::ofstream ofs(logpath, std::ios::app);
-    if (!ofs) return;
-    ofs << "[" << now_hhmmss() << "] " << line << "\n";
-  };
+  // ChatCore 는 링에 넣기만 하고 파일 쓰기는 로거 스레드가 담당
+  auto logger = std::make_shared<core::AsyncLogger>(lopt);
+
+  // --history-dir: chat 기록을 방별 세그먼트에 남기고 재시작 때 복원
+  std::shared_ptr<core::SegmentStore> store;
+  if (persist) {
+    store = std::make_shared<core::SegmentStore>(sopt);
+    if (!core::SegmentStore::supported() || !store->start()) {
+      std::cerr << "history store unavailable, keeping history in memory only\n";
+      store.reset();
+    }
+  }
+  // --compress: hello 에서 "compress":"deflate" 를 요청한 연결에 큰 프레임을 압축해 보냄
+  if (zopt.enabled && !zcodec::supported()) {
+    std::cerr << "built without zlib, compression disabled\n";
+    zopt.enabled = false;
+  }
+  // --keepalive: SEC 동안 조용한 연결에 ping, --keepalive-timeout 안에 답이 없으면 끊음
+  std::shared_ptr<core::Keepalive> ka;
+  if (keepalive) ka = std::make_shared<core::Keepalive>(kopt);
+  auto core = std::make_shared<core::ChatCore>(core::AsyncLogger::make_log_fn(logger), hist, store,
+                                               zopt, ka);
+
+  // --mux-port: chat_gateway 의 다중화 링크를 받음 (WS 클라이언트마다 채널 = 연결 하나)
+  // 어떤 --mode 와도 같이 뜸. 채널 송신 큐 상한은 --slow-policy/--out-max-* 를 따름
+  transport::tcp::MuxServerOptions mopt;
+  mopt.backlog = opt.backlog;
+  mopt.outbound = opt.outbound;
+  transport::tcp::MuxServer mux(core, mopt);
+  if (mux_port > 0 && !mux.start(mux_port)) {
+    std::cerr << "failed to start mux listener\n";
+    return 1;
+  }
+
+#ifdef CHAT_HAS_URING
+  if (use_uring) {
+    transport::uring::UringServerOptions uopt;
+    uopt.backlog = opt.backlog;
+    uopt.outbound = opt.outbound;
+    transport::uring::UringServer userver(core, uopt);
+    if (userver.start(port)) {
+      std::cout << "Press ENTER to stop...\n";
+      std::string tmp;
+      std::getline(std::cin, tmp);
+      userver.stop();
+      mux.stop();
+      if (ka) ka->stop();
+      logger->stop();
+      if (store) store->stop();
+      print_outbound_stats(userver.outbound_stats());
+      if (mux_port > 0) print_outbound_stats(mux.outbound_stats(), "mux outbound");
+      print_log_stats(*logger);
+      print_store_stats(store.get());
+      print_compress_stats(*core, zopt.enabled);
+      print_keepalive_stats(ka.get());
+      return 0;
+    }
+    std::cerr << "io_uring unavailable, falling back to reactor mode\n";
+  }
+#endif
+  if (use_uring) opt.mode = transport::tcp::TcpMode::Reactor;
 
-  auto core = std::make_shared<core::ChatCore>(logger);
-  transport::tcp::TcpServer server(core);
+  transport::tcp::TcpServer server(core, opt);
 
   if (!server.start(port)) {
     std::cerr << "failed to start server\n";
@@ -64,5 +243,15 @@ int main(int argc, char** argv) {
   std::getline(std::cin, tmp);
 
   server.stop();
+  mux.stop();
+  if (ka) ka->stop();
+  logger->stop();
+  if (store) store->stop();
+  if (opt.mode != transport::tcp::TcpMode::Threaded) print_outbound_stats(server.outbound_stats());
+  if (mux_port > 0) print_outbound_stats(mux.outbound_stats(), "mux outbound");
+  print_log_stats(*logger);
+  print_store_stats(store.get());
+  print_compress_stats(*core, zopt.enabled);
+  print_keepalive_stats(ka.get());
   return 0;
 }
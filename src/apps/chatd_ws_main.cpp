@@ -1,58 +1,75 @@
 #include <iostream>
-#include <fstream>
-#include <filesystem>
-#include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <string>
 
+#include "core/async_logger.h"
 #include "core/chat_core.h"
 #include "transport/ws/ws_server.h"
 
-static std::string today_yyyymmdd() {
-  using namespace std::chrono;
-  auto now = system_clock::now();
-  std::time_t t = system_clock::to_time_t(now);
-  std::tm tm{};
-#ifdef _WIN32
-  localtime_s(&tm, &t);
-#else
-  tm = *std::localtime(&t);
-#endif
-  std::ostringstream oss;
-  oss << std::put_time(&tm, "%Y%m%d");
-  return oss.str();
-}
-
-static std::string now_hhmmss() {
-  using namespace std::chrono;
-  auto now = system_clock::now();
-  std::time_t t = system_clock::to_time_t(now);
-  std::tm tm{};
-#ifdef _WIN32
-  localtime_s(&tm, &t);
-#else
-  tm = *std::localtime(&t);
-#endif
-  std::ostringstream oss;
-  oss << std::put_time(&tm, "%H:%M:%S");
-  return oss.str();
+static void print_outbound_stats(const core::OutboundStats& st) {
+  std::cout << "outbound: queued=" << st.queued
+            << " coalesced=" << st.coalesced
+            << " dropped_oldest=" << st.dropped_oldest
+            << " dropped_chat=" << st.dropped_chat
+            << " dropped_new=" << st.dropped_new
+            << " disconnected=" << st.disconnected
+            << " peak_bytes=" << st.peak_bytes << "\n";
 }
 
+// 사용법: chatd_ws [port] [--mode async|threaded] [--io-threads N] [--deflate] [--deflate-level N]
+//                  [--slow-policy disconnect|drop-oldest|drop-chat]
+//                  [--out-max-bytes N] [--out-max-msgs N]
+//                  [--keepalive SEC] [--keepalive-timeout SEC]
 int main(int argc, char** argv) {
   int port = 9001;
-  if (argc >= 2) port = std::stoi(argv[1]);
-
-  std::filesystem::create_directories("logs");
-  std::string logpath = "logs/ws_chat_" + today_yyyymmdd() + ".txt";
-
-  auto logger = [logpath](const std::string& line) {
-    std::ofstream ofs(logpath, std::ios::app);
-    if (!ofs) return;
-    ofs << "[" << now_hhmmss() << "] " << line << "\n";
-  };
+  transport::ws::WsServerOptions wopt;
+  core::KeepaliveOptions kopt;
+  bool keepalive = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--mode" && i + 1 < argc) {
+      std::string m = argv[++i];
+      if (m == "async") wopt.mode = transport::ws::WsMode::Async;
+      else if (m == "threaded") wopt.mode = transport::ws::WsMode::Threaded;
+      else {
+        std::cerr << "unknown mode: " << m << "\n";
+        return 1;
+      }
+    }
+    else if (a == "--io-threads" && i + 1 < argc) wopt.io_threads = std::stoi(argv[++i]);
+    else if (a == "--slow-policy" && i + 1 < argc) {
+      std::string p = argv[++i];
+      if (p == "disconnect") wopt.outbound.policy = core::SlowConsumerPolicy::Disconnect;
+      else if (p == "drop-oldest") wopt.outbound.policy = core::SlowConsumerPolicy::DropOldest;
+      else if (p == "drop-chat") wopt.outbound.policy = core::SlowConsumerPolicy::DropChat;
+      else {
+        std::cerr << "unknown slow-consumer policy: " << p << "\n";
+        return 1;
+      }
+    }
+    else if (a == "--out-max-bytes" && i + 1 < argc) wopt.outbound.max_bytes = std::stoull(argv[++i]);
+    else if (a == "--out-max-msgs" && i + 1 < argc) wopt.outbound.max_msgs = std::stoull(argv[++i]);
+    else if (a == "--keepalive" && i + 1 < argc) {
+      kopt.idle_ms = static_cast<uint32_t>(std::stoul(argv[++i]) * 1000);
+      keepalive = true;
+    }
+    else if (a == "--keepalive-timeout" && i + 1 < argc) {
+      kopt.timeout_ms = static_cast<uint32_t>(std::stoul(argv[++i]) * 1000);
+    }
+    else if (a == "--deflate") wopt.deflate = true;
+    else if (a == "--deflate-level" && i + 1 < argc) wopt.deflate_level = std::stoi(argv[++i]);
+    else port = std::stoi(a);
+  }
 
-  auto core = std::make_shared<core::ChatCore>(logger);
-  transport::ws::WsServer server(core);
+  core::AsyncLoggerOptions lopt;
+  lopt.prefix = "ws_chat_";
+  auto logger = std::make_shared<core::AsyncLogger>(lopt);
+  // --keepalive: 조용한 연결에 ping 프레임, 답(pong)이 없으면 끊음
+  std::shared_ptr<core::Keepalive> ka;
+  if (keepalive) ka = std::make_shared<core::Keepalive>(kopt);
+  auto core = std::make_shared<core::ChatCore>(core::AsyncLogger::make_log_fn(logger),
+                                               core::HistoryLimits{}, nullptr,
+                                               core::CompressOptions{}, ka);
+  transport::ws::WsServer server(core, wopt);
 
   if (!server.start(port)) {
     std::cerr << "failed to start ws server\n";
@@ -64,5 +81,12 @@ int main(int argc, char** argv) {
   std::getline(std::cin, tmp);
 
   server.stop();
+  if (ka) ka->stop();
+  print_outbound_stats(server.outbound_stats());
+  if (ka) {
+    std::cout << "keepalive: pings=" << ka->stats().pings
+              << " evicted=" << ka->stats().evicted << "\n";
+  }
+  logger->stop();
   return 0;
 }
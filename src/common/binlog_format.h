@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// 바이너리 채팅 로그 포맷 (chatd 로거가 쓰고 chat_logcat 이 읽음)
+//
+// [헤더 16B]  magic "CHATBLG1" | base_unix_us (int64 LE)
+// [레코드]*   varint body_len | body
+// [푸터 16B]  last_index_off (uint64 LE) | magic "CBLGIDX1"   (정상 종료 시에만)
+//
+// body 는 varint kind 로 시작
+// - 이벤트 (kind 1..4 = core::LogEvent)
+//     kind | ts_us | room_id | nick_id | text(나머지 바이트)
+//     ts_us 는 base_unix_us 기준 단조(steady clock) 증가 오프셋
+// - kDefRoom / kDefNick: kind | id | name(나머지 바이트)
+//     id 는 파일마다 1부터 부여, 0 = 없음. 처음 쓰이기 직전에 한 번 정의됨
+// - kIndex: 직전 인덱스 이후 블록 요약 (리더가 블록 단위로 건너뛰기 위함)
+//     kind | prev_index_off (0 = 없음) | block_off | block_len | count
+//          | ts_min | ts_max
+//          | n_rooms | room_id*  | n_nicks | nick_id*
+//          | n_defs | (def_kind | id | name_len | name)*   <- 블록 안에서 정의된 이름들
+namespace binlog {
+
+inline constexpr char kMagic[8] = {'C', 'H', 'A', 'T', 'B', 'L', 'G', '1'};
+inline constexpr char kFooterMagic[8] = {'C', 'B', 'L', 'G', 'I', 'D', 'X', '1'};
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kFooterSize = 16;
+
+enum Kind : uint32_t {
+  kConnect = 1,
+  kDisconnect = 2,
+  kSystem = 3,
+  kChat = 4,
+  kDefRoom = 16,
+  kDefNick = 17,
+  kIndex = 18,
+};
+
+inline void put_varint(std::string& out, uint64_t v) {
+  while (v >= 0x80) {
+    out += static_cast<char>((v & 0x7f) | 0x80);
+    v >>= 7;
+  }
+  out += static_cast<char>(v);
+}
+
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+  v = 0;
+  for (int shift = 0; shift < 64 && p < end; shift += 7) {
+    uint8_t b = *p++;
+    v |= static_cast<uint64_t>(b & 0x7f) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+inline size_t varint_size(uint64_t v) {
+  size_t n = 1;
+  while (v >= 0x80) { v >>= 7; n++; }
+  return n;
+}
+
+inline void put_u64le(std::string& out, uint64_t v) {
+  for (int i = 0; i < 8; i++) out += static_cast<char>((v >> (8 * i)) & 0xff);
+}
+
+inline uint64_t get_u64le(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+  return v;
+}
+
+} // namespace binlog
@@ -0,0 +1,94 @@
+#include "common/frame_decoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace framing {
+
+namespace {
+constexpr size_t kMinRead = 4 * 1024;
+}
+
+FrameDecoder::FrameDecoder(size_t initial_capacity, uint32_t max_frame, size_t prefix_bytes)
+  : buf_(std::max(initial_capacity, kMinRead)), initial_(buf_.size()),
+    max_frame_(max_frame), prefix_(prefix_bytes) {}
+
+uint8_t* FrameDecoder::reserve_(size_t min_space) {
+  if (rd_ == wr_) {
+    rd_ = wr_ = 0;
+    // 큰 프레임 한 번에 늘어난 버퍼를 유휴 연결이 계속 쥐고 있지 않게 (비었을 때만)
+    if (buf_.size() > initial_) std::vector<uint8_t>(initial_).swap(buf_);
+  }
+
+  // 부분 프레임이 통째로 들어갈 공간을 미리 확보해 두면 다음 recv 에서 완성 가능
+  size_t want = std::max(min_space, need_ > buffered() ? need_ - buffered() : 0);
+  if (buf_.size() - wr_ < want) {
+    if (rd_ > 0) {
+      std::memmove(buf_.data(), buf_.data() + rd_, wr_ - rd_);
+      wr_ -= rd_;
+      rd_ = 0;
+    }
+    if (buf_.size() - wr_ < want) {
+      buf_.resize(std::max(buf_.size() * 2, wr_ + want));
+    }
+  }
+  return buf_.data() + wr_;
+}
+
+FrameDecoder::ReadResult FrameDecoder::read_some(net::socket_t s) {
+  if (error_) return ReadResult::Error;
+  uint8_t* p = reserve_(kMinRead);
+  long long n = net::recv_some(s, p, buf_.size() - wr_);
+  if (n > 0) {
+    wr_ += static_cast<size_t>(n);
+    return ReadResult::Ok;
+  }
+  if (n == 0) return ReadResult::Closed;
+  if (net::would_block(net::last_error())) return ReadResult::WouldBlock;
+  return ReadResult::Error;
+}
+
+void FrameDecoder::append(const uint8_t* data, size_t len) {
+  if (len == 0) return;
+  uint8_t* p = reserve_(len);
+  std::memcpy(p, data, len);
+  wr_ += len;
+}
+
+uint8_t* FrameDecoder::prepare(size_t min_space, size_t& space) {
+  uint8_t* p = reserve_(std::max(min_space, kMinRead));
+  space = buf_.size() - wr_;
+  return p;
+}
+
+bool FrameDecoder::next(std::string_view& payload, uint32_t* tag) {
+  if (error_) return false;
+  size_t avail = wr_ - rd_;
+  size_t head = prefix_ + sizeof(uint32_t);
+  if (avail < head) return false;
+
+  uint32_t be_len = 0;
+  std::memcpy(&be_len, buf_.data() + rd_ + prefix_, sizeof(be_len));
+  uint32_t len = ntohl(be_len);
+  if (len > max_frame_) {
+    error_ = true;
+    return false;
+  }
+
+  size_t total = head + len;
+  if (avail < total) {
+    need_ = total;
+    return false;
+  }
+
+  if (tag && prefix_ == sizeof(uint32_t)) {
+    uint32_t be_tag = 0;
+    std::memcpy(&be_tag, buf_.data() + rd_, sizeof(be_tag));
+    *tag = ntohl(be_tag);
+  }
+  payload = std::string_view(reinterpret_cast<const char*>(buf_.data() + rd_ + head), len);
+  rd_ += total;
+  need_ = 0;
+  return true;
+}
+
+} // namespace framing
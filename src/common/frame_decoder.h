@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "net/net_platform.h"
+
+namespace framing {
+
+constexpr uint32_t kMaxFrameSize = 10 * 1024 * 1024;
+// 길이 헤더 최상위 비트: payload 가 zlib 압축됨 (common/zcodec.h)
+// 서버 -> 클라이언트 방향, hello 에서 압축을 협상한 연결에만 씀
+constexpr uint32_t kFrameCompressed = 0x80000000u;
+
+// 길이 프레이밍 스트리밍 디코더 (연결당 1개, 버퍼 재사용)
+// - 소켓에서 한 번에 읽을 수 있는 만큼 읽고, 완성된 프레임을 복사 없이 view 로 꺼냄
+// - 부분 프레임은 다음 read 까지 보관. 버퍼 끝에 걸리면 남은 꼬리만 앞으로 당겨 프레임을 연속으로 유지
+// - next() 로 받은 view 는 다음 read_some()/append()/prepare() 호출 전까지만 유효
+// - 큰 프레임으로 늘어난 버퍼는 다 꺼내서 빈 뒤 다음 read 때 initial_capacity 로 되돌림
+// - prefix_bytes > 0 이면 길이 헤더 앞에 그만큼의 태그가 붙은 포맷 (mux 링크: 채널 4B)
+class FrameDecoder {
+public:
+  enum class ReadResult { Ok, WouldBlock, Closed, Error };
+
+  explicit FrameDecoder(size_t initial_capacity = 64 * 1024,
+                        uint32_t max_frame = kMaxFrameSize, size_t prefix_bytes = 0);
+
+  // recv 1회 (블로킹 소켓이면 데이터가 올 때까지 대기)
+  // 논블로킹 소켓은 WouldBlock 이 나올 때까지 반복 호출
+  ReadResult read_some(net::socket_t s);
+
+  // 이미 다른 곳(io_uring 버퍼 등)에서 받은 바이트 추가
+  void append(const uint8_t* data, size_t len);
+
+  // 비동기 read(asio 등)가 버퍼에 바로 받게: 최소 min_space 바이트 자리를 내주고
+  // (space = 실제로 쓸 수 있는 크기) 받은 만큼 commit
+  uint8_t* prepare(size_t min_space, size_t& space);
+  void commit(size_t n) { wr_ += n; }
+
+  // 완성된 프레임 하나를 꺼냄. 부분 프레임뿐이거나 에러면 false
+  // tag: prefix 가 4B 면 그 값 (BE)
+  bool next(std::string_view& payload, uint32_t* tag = nullptr);
+
+  // 최대 크기를 넘는 길이 헤더를 받음 -> 연결 종료 대상
+  bool error() const { return error_; }
+
+  size_t buffered() const { return wr_ - rd_; }
+
+private:
+  uint8_t* reserve_(size_t min_space);
+
+  std::vector<uint8_t> buf_;
+  size_t initial_; // 비면 이 크기로 되돌림
+  size_t rd_ = 0;
+  size_t wr_ = 0;
+  size_t need_ = 0; // 현재 부분 프레임을 완성하는 데 필요한 총 바이트 (헤더 포함)
+  uint32_t max_frame_;
+  size_t prefix_;
+  bool error_ = false;
+};
+
+} // namespace framing
@@ -1,4 +1,5 @@
 #include "common/framing.h"
+#include "common/frame_decoder.h"
 #include <cstring>
 #include <vector>
 
@@ -13,31 +14,38 @@ static uint32_t from_be32(uint32_t x) {
 }
 
 bool send_message(net::socket_t s, const std::string& msg) {
-  if (msg.size() > 10 * 1024 * 1024) return false;
+  if (msg.size() > kMaxFrameSize) return false;
   uint32_t len = static_cast<uint32_t>(msg.size());
   uint32_t be_len = to_be32(len);
 
-  std::vector<uint8_t> buf(sizeof(uint32_t) + msg.size());
-  std::memcpy(buf.data(), &be_len, sizeof(uint32_t));
-  if (!msg.empty()) {
-    std::memcpy(buf.data() + sizeof(uint32_t), msg.data(), msg.size());
-  }
-  return net::send_all(s, buf.data(), buf.size());
+  // 헤더와 payload 를 별도 iovec 으로 (합치기 위한 힙 버퍼/복사 없음)
+  net::IoSlice iov[2] = {
+    {reinterpret_cast<const uint8_t*>(&be_len), sizeof(uint32_t)},
+    {reinterpret_cast<const uint8_t*>(msg.data()), msg.size()},
+  };
+  return net::send_all_v(s, iov, 2);
 }
 
 bool recv_message(net::socket_t s, std::string& out) {
+  bool compressed = false;
+  return recv_message(s, out, compressed) && !compressed;
+}
+
+bool recv_message(net::socket_t s, std::string& out, bool& compressed) {
   uint32_t be_len = 0;
   if (!net::recv_exact(s, reinterpret_cast<uint8_t*>(&be_len), sizeof(uint32_t)))
     return false;
 
   uint32_t len = from_be32(be_len);
-  if (len > 10 * 1024 * 1024) return false;
+  compressed = (len & kFrameCompressed) != 0;
+  len &= ~kFrameCompressed;
+  if (len > kMaxFrameSize) return false;
 
-  std::vector<uint8_t> payload(len);
+  // 중간 버퍼 없이 out 에 바로 수신
+  out.resize(len);
   if (len > 0) {
-    if (!net::recv_exact(s, payload.data(), payload.size())) return false;
+    if (!net::recv_exact(s, reinterpret_cast<uint8_t*>(&out[0]), len)) return false;
   }
-  out.assign(reinterpret_cast<const char*>(payload.data()), payload.size());
   return true;
 }
 
@@ -8,4 +8,6 @@ namespace framing {
 
     bool send_message(net::socket_t s, const std::string& msg);
     bool recv_message(net::socket_t s, std::string& out);
+    // 압축 플래그(kFrameCompressed)가 붙은 프레임도 받음 (payload 는 압축된 그대로)
+    bool recv_message(net::socket_t s, std::string& out, bool& compressed);
 }
\ No newline at end of file
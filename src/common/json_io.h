@@ -1,5 +1,8 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "net/net_platform.h"
 #include "common/framing.h"
 #include "nlohmann/json.hpp"
@@ -12,17 +15,51 @@ inline bool send_json(net::socket_t s, const json& j) {
   return framing::send_message(s, j.dump());
 }
 
-// framing으로 받은 문자열을 JSON으로 파싱
-inline bool recv_json(net::socket_t s, json& out) {
-  std::string payload;
-  if (!framing::recv_message(s, payload)) return false;
-
+// 프레임 payload(view)를 복사 없이 바로 파싱
+inline bool parse_json(std::string_view payload, json& out) {
   try {
-    out = json::parse(payload);
+    out = json::parse(payload.begin(), payload.end());
     return true;
   } catch (...) {
     return false;
   }
 }
 
+// 프로토콜 v2: 같은 메시지를 MessagePack 으로
+// 메시지는 항상 map 이라 첫 바이트(fixmap/map16/map32)로 JSON('{' 또는 공백)과 구분
+inline bool is_msgpack(std::string_view payload) {
+  if (payload.empty()) return false;
+  const uint8_t b0 = static_cast<uint8_t>(payload[0]);
+  return (b0 & 0xF0) == 0x80 || b0 == 0xDE || b0 == 0xDF;
+}
+
+inline bool parse_msgpack(std::string_view payload, json& out) {
+  out = json::from_msgpack(payload.begin(), payload.end(), true, false);
+  return !out.is_discarded();
+}
+
+inline bool send_msgpack(net::socket_t s, const json& j) {
+  std::vector<uint8_t> b = json::to_msgpack(j);
+  return framing::send_message(s, std::string(b.begin(), b.end()));
+}
+
+// 인코딩을 보고 파싱 (v1/v2 혼용 수신)
+inline bool parse_any(std::string_view payload, json& out) {
+  return is_msgpack(payload) ? parse_msgpack(payload, out) : parse_json(payload, out);
+}
+
+// framing으로 받은 문자열을 JSON으로 파싱
+inline bool recv_json(net::socket_t s, json& out) {
+  std::string payload;
+  if (!framing::recv_message(s, payload)) return false;
+  return parse_json(payload, out);
+}
+
+// recv_json 과 같지만 v2(MessagePack) 프레임도 받음
+inline bool recv_any(net::socket_t s, json& out) {
+  std::string payload;
+  if (!framing::recv_message(s, payload)) return false;
+  return parse_any(payload, out);
+}
+
 } // namespace jsonio
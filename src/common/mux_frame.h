@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// 게이트웨이 <-> chatd_tcp 다중화 링크 포맷 (chatd_tcp --mux-port, chat_gateway --links)
+// WS 클라이언트 하나 = 채널 하나. 링크 몇 개에 많은 채널을 섞어 보냄
+//
+// [channel 4B BE][len 4B BE][payload]   <- 일반 길이 프레임 앞에 채널 번호만 붙임
+// - 서버는 공유 프레임의 tcp_bytes() 를 그대로 쓰고 앞에 4B 만 더 보냄 (writev)
+// - 압축 플래그(kFrameCompressed)는 쓰지 않음 (채널은 압축을 협상하지 않음)
+//
+// channel 0 = 컨트롤 프레임: payload = op(1B) | channel(4B BE) | 부가 정보
+// - Open : 게이트웨이 -> 서버. 새 WS 클라이언트 (부가 정보 = 클라이언트 주소)
+// - Close: 양방향
+//     게이트웨이가 보냄 -> 서버는 그 채널을 바로 on_disconnect
+//     서버가 보냄(close/keepalive/느린 소비자) -> 게이트웨이는 WS 를 닫고 Close 로 답함
+//     서버는 그 답을 받을 때 on_disconnect (채널의 수신 처리는 링크 수신 스레드 하나가 맡음)
+// 채널 번호는 게이트웨이가 링크마다 1부터 매기고 다시 쓰지 않음
+namespace mux {
+
+constexpr uint32_t kControl = 0;
+constexpr size_t kChannelBytes = 4;
+constexpr size_t kHeaderBytes = kChannelBytes + sizeof(uint32_t);
+
+enum class Op : uint8_t { Open = 1, Close = 2 };
+
+inline void put_u32(uint8_t* p, uint32_t v) {
+  p[0] = static_cast<uint8_t>(v >> 24);
+  p[1] = static_cast<uint8_t>(v >> 16);
+  p[2] = static_cast<uint8_t>(v >> 8);
+  p[3] = static_cast<uint8_t>(v);
+}
+
+inline uint32_t get_u32(const void* src) {
+  const uint8_t* p = static_cast<const uint8_t*>(src);
+  return (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | p[3];
+}
+
+// 채널 헤더 + 길이 헤더 (payload 는 따로 이어 보냄)
+inline void put_header(uint8_t* out, uint32_t channel, size_t payload_len) {
+  put_u32(out, channel);
+  put_u32(out + kChannelBytes, static_cast<uint32_t>(payload_len));
+}
+
+// 컨트롤 프레임 하나 (헤더 포함 전송 바이트)
+inline std::string control(Op op, uint32_t channel, std::string_view info = {}) {
+  std::string out(kHeaderBytes + 5 + info.size(), '\0');
+  uint8_t* p = reinterpret_cast<uint8_t*>(out.data());
+  put_header(p, kControl, 5 + info.size());
+  p[kHeaderBytes] = static_cast<uint8_t>(op);
+  put_u32(p + kHeaderBytes + 1, channel);
+  if (!info.empty()) std::memcpy(p + kHeaderBytes + 5, info.data(), info.size());
+  return out;
+}
+
+inline bool parse_control(std::string_view payload, Op& op, uint32_t& channel,
+                          std::string_view& info) {
+  if (payload.size() < 5) return false;
+  op = static_cast<Op>(static_cast<uint8_t>(payload[0]));
+  channel = get_u32(payload.data() + 1);
+  info = payload.substr(5);
+  return channel != kControl;
+}
+
+} // namespace mux
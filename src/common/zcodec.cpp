@@ -0,0 +1,91 @@
+#include "common/zcodec.h"
+
+#ifdef CHAT_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace zcodec {
+
+#ifdef CHAT_HAS_ZLIB
+
+namespace {
+constexpr size_t kMaxDict = 32 * 1024;
+}
+
+std::shared_ptr<const Dict> Dict::make(std::string bytes) {
+  if (bytes.size() > kMaxDict) bytes.erase(0, bytes.size() - kMaxDict); // 뒤쪽이 더 유효
+  auto d = std::make_shared<Dict>();
+  d->id = static_cast<uint32_t>(
+    adler32(adler32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(bytes.data()),
+            static_cast<uInt>(bytes.size())));
+  d->bytes = std::move(bytes);
+  return d;
+}
+
+bool supported() {
+  return true;
+}
+
+bool deflate(std::string_view in, const Dict* dict, int level, std::string& out) {
+  z_stream zs{};
+  if (deflateInit(&zs, level) != Z_OK) return false;
+  if (dict && deflateSetDictionary(&zs, reinterpret_cast<const Bytef*>(dict->bytes.data()),
+                                   static_cast<uInt>(dict->bytes.size())) != Z_OK) {
+    deflateEnd(&zs);
+    return false;
+  }
+  out.resize(deflateBound(&zs, static_cast<uLong>(in.size())));
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+  zs.avail_in = static_cast<uInt>(in.size());
+  zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+  zs.avail_out = static_cast<uInt>(out.size());
+  int rc = ::deflate(&zs, Z_FINISH);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+  return rc == Z_STREAM_END;
+}
+
+bool inflate(std::string_view in, const DictLookup& dicts, size_t max_out, std::string& out) {
+  z_stream zs{};
+  if (inflateInit(&zs) != Z_OK) return false;
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+  zs.avail_in = static_cast<uInt>(in.size());
+
+  out.clear();
+  char chunk[16 * 1024];
+  int rc = Z_OK;
+  while (rc != Z_STREAM_END) {
+    zs.next_out = reinterpret_cast<Bytef*>(chunk);
+    zs.avail_out = sizeof(chunk);
+    rc = ::inflate(&zs, Z_NO_FLUSH);
+    if (rc == Z_NEED_DICT) {
+      const Dict* d = dicts ? dicts(static_cast<uint32_t>(zs.adler)) : nullptr;
+      if (!d || inflateSetDictionary(&zs, reinterpret_cast<const Bytef*>(d->bytes.data()),
+                                     static_cast<uInt>(d->bytes.size())) != Z_OK) break;
+      rc = Z_OK;
+      continue;
+    }
+    if (rc != Z_OK && rc != Z_STREAM_END) break;
+    out.append(chunk, sizeof(chunk) - zs.avail_out);
+    if (out.size() > max_out) break;
+    if (rc == Z_OK && zs.avail_in == 0 && zs.avail_out != 0) break; // 잘린 스트림
+  }
+  inflateEnd(&zs);
+  return rc == Z_STREAM_END && out.size() <= max_out;
+}
+
+#else // !CHAT_HAS_ZLIB
+
+std::shared_ptr<const Dict> Dict::make(std::string bytes) {
+  auto d = std::make_shared<Dict>();
+  d->bytes = std::move(bytes);
+  return d;
+}
+
+bool supported() { return false; }
+bool deflate(std::string_view, const Dict*, int, std::string&) { return false; }
+bool inflate(std::string_view, const DictLookup&, size_t, std::string&) { return false; }
+
+#endif
+
+} // namespace zcodec
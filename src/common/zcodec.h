@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// 프레임 payload 압축 (zlib deflate)
+// - TCP: 길이 헤더의 최상위 비트(framing::kFrameCompressed)가 켜진 프레임의 payload 가 zlib 스트림
+// - 선택적으로 preset dictionary 사용: zlib 헤더의 DICTID(= 사전의 adler32)로 어떤 사전인지 식별
+// - CHAT_HAS_ZLIB 없이 빌드하면 supported() 가 false 이고 압축/해제는 항상 실패
+namespace zcodec {
+
+struct Dict {
+  uint32_t id = 0;   // adler32(bytes) == zlib DICTID
+  std::string bytes; // 최대 32KB (deflate window)
+  static std::shared_ptr<const Dict> make(std::string bytes);
+};
+using DictPtr = std::shared_ptr<const Dict>;
+
+// 스트림이 요구하는 사전을 id 로 찾음 (없으면 nullptr)
+using DictLookup = std::function<const Dict*(uint32_t id)>;
+
+bool supported();
+
+// level: 1..9 (zlib). 실패하면 false
+bool deflate(std::string_view in, const Dict* dict, int level, std::string& out);
+// max_out 을 넘게 풀리면 실패 (압축 폭탄 방지)
+bool inflate(std::string_view in, const DictLookup& dicts, size_t max_out, std::string& out);
+
+} // namespace zcodec
@@ -0,0 +1,296 @@
+#include "core/async_logger.h"
+
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace core {
+
+namespace {
+
+constexpr size_t kMaxBatchBytes = 256 * 1024; // write 한 번에 모으는 최대 크기
+
+int64_t wall_now_us() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+int64_t steady_now_us() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+std::tm local_tm(int64_t ts_us) {
+  std::time_t t = static_cast<std::time_t>(ts_us / 1000000);
+  std::tm tm{};
+#ifdef _WIN32
+  localtime_s(&tm, &t);
+#else
+  localtime_r(&t, &tm);
+#endif
+  return tm;
+}
+
+std::string yyyymmdd(int64_t ts_us) {
+  std::tm tm = local_tm(ts_us);
+  char b[16];
+  std::strftime(b, sizeof(b), "%Y%m%d", &tm);
+  return b;
+}
+
+} // namespace
+
+AsyncLogger::AsyncLogger(AsyncLoggerOptions opt) : opt_(std::move(opt)) {
+  size_t cap = 2;
+  while (cap < opt_.capacity) cap <<= 1;
+  slots_ = std::make_unique<Slot[]>(cap);
+  mask_ = cap - 1;
+  for (size_t i = 0; i < cap; i++) slots_[i].seq.store(i, std::memory_order_relaxed);
+
+  std::error_code ec;
+  std::filesystem::create_directories(opt_.dir, ec);
+
+  anchor_wall_us_ = wall_now_us();
+  anchor_mono_us_ = steady_now_us();
+
+  running_.store(true, std::memory_order_release);
+  writer_ = std::thread([this] { run_(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+  stop();
+}
+
+LogFn AsyncLogger::make_log_fn(const std::shared_ptr<AsyncLogger>& lg) {
+  return [lg](const LogRecord& r) { lg->log(r); };
+}
+
+void AsyncLogger::stop() {
+  running_.store(false, std::memory_order_release);
+  if (writer_.joinable()) writer_.join();
+}
+
+uint64_t AsyncLogger::mono_now_() const {
+  int64_t d = steady_now_us() - anchor_mono_us_;
+  return d > 0 ? static_cast<uint64_t>(d) : 0;
+}
+
+void AsyncLogger::log(const LogRecord& r) {
+  if (!running_.load(std::memory_order_acquire)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // 슬롯 예약: seq == pos 면 비어 있음, seq < pos 면 writer 가 아직 못 비움(가득 참)
+  size_t pos = head_.load(std::memory_order_relaxed);
+  Slot* s;
+  for (;;) {
+    s = &slots_[pos & mask_];
+    size_t seq = s->seq.load(std::memory_order_acquire);
+    auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+
+  s->mono_us = mono_now_();
+  s->ev = r.ev;
+  s->room.assign(r.room);
+  s->nick.assign(r.nick);
+  s->text.assign(r.text);
+  s->seq.store(pos + 1, std::memory_order_release);
+}
+
+const std::string& AsyncLogger::stamp_for_(int64_t ts_us) {
+  int64_t sec = ts_us / 1000000;
+  if (sec != last_sec_) {
+    last_sec_ = sec;
+    std::tm tm = local_tm(ts_us);
+    char b[16];
+    std::strftime(b, sizeof(b), "[%H:%M:%S] ", &tm);
+    stamp_ = b;
+  }
+  return stamp_;
+}
+
+void AsyncLogger::encode_(std::string& buf, const LogRecord& r, uint64_t mono_us) {
+  if (opt_.format == LogFormat::Binary) {
+    bin_.append(buf, file_bytes_, r, mono_us);
+    return;
+  }
+  buf += stamp_for_(anchor_wall_us_ + static_cast<int64_t>(mono_us));
+  append_log_line(buf, r);
+  buf += '\n';
+}
+
+bool AsyncLogger::has_pending_() const {
+  return slots_[tail_ & mask_].seq.load(std::memory_order_acquire) == tail_ + 1;
+}
+
+size_t AsyncLogger::drain_(std::string& buf) {
+  size_t n = 0;
+  while (buf.size() < kMaxBatchBytes) {
+    Slot& s = slots_[tail_ & mask_];
+    if (s.seq.load(std::memory_order_acquire) != tail_ + 1) break;
+
+    encode_(buf, LogRecord{s.ev, s.room, s.nick, s.text}, s.mono_us);
+    s.room.clear();
+    s.nick.clear();
+    s.text.clear();
+    s.seq.store(tail_ + mask_ + 1, std::memory_order_release);
+    ++tail_;
+    ++n;
+  }
+  return n;
+}
+
+void AsyncLogger::open_file_(int64_t now) {
+  namespace fs = std::filesystem;
+  const bool binary = opt_.format == LogFormat::Binary;
+  for (;;) {
+    std::string name = opt_.prefix + day_;
+    if (part_ > 0) name += "_" + std::to_string(part_);
+    name += binary ? ".bin" : ".txt";
+    fs::path p = fs::path(opt_.dir) / name;
+
+    // 재시작 시 이미 꽉 찬 조각은 건너뜀 (바이너리는 id 사전이 파일마다 독립이라 이어 쓰지 않음)
+    std::error_code ec;
+    uintmax_t sz = fs::exists(p, ec) ? fs::file_size(p, ec) : 0;
+    if (ec) sz = 0;
+    if ((binary && sz > 0) || (opt_.max_file_bytes > 0 && sz >= opt_.max_file_bytes)) {
+      ++part_;
+      continue;
+    }
+
+    fp_ = std::fopen(p.string().c_str(), "ab");
+    file_bytes_ = static_cast<size_t>(sz);
+    last_fsync_us_ = now;
+    if (fp_ && binary) {
+      std::string hdr;
+      bin_.begin(hdr, anchor_wall_us_);
+      std::fwrite(hdr.data(), 1, hdr.size(), fp_);
+      file_bytes_ += hdr.size();
+    }
+    return;
+  }
+}
+
+void AsyncLogger::roll_if_needed_(int64_t now) {
+  std::string day = yyyymmdd(now);
+  const bool full = opt_.max_file_bytes > 0 && file_bytes_ >= opt_.max_file_bytes;
+  if (fp_ && day == day_ && !full) return;
+
+  if (fp_) {
+    rotations_.fetch_add(1, std::memory_order_relaxed);
+    close_file_();
+    if (day == day_) ++part_;
+  }
+  if (day != day_) {
+    day_ = std::move(day);
+    part_ = 0;
+  }
+  open_file_(now);
+}
+void AsyncLogger::sync_file_() {
+  if (!fp_) return;
+  std::fflush(fp_);
+#ifdef _WIN32
+  _commit(_fileno(fp_));
+#else
+  ::fsync(fileno(fp_));
+#endif
+  unsynced_ = false;
+}
+
+void AsyncLogger::close_file_() {
+  if (!fp_) return;
+  if (opt_.format == LogFormat::Binary) {
+    std::string tail;
+    bin_.finish(tail, file_bytes_);
+    std::fwrite(tail.data(), 1, tail.size(), fp_);
+    file_bytes_ += tail.size();
+    unsynced_ = true;
+  }
+  if (opt_.fsync != FsyncPolicy::Never && unsynced_) sync_file_();
+  std::fclose(fp_);
+  fp_ = nullptr;
+}
+
+void AsyncLogger::write_batch_(const std::string& buf, int64_t now) {
+  if (!fp_) return;
+
+  std::fwrite(buf.data(), 1, buf.size(), fp_);
+  std::fflush(fp_);
+  file_bytes_ += buf.size();
+  unsynced_ = true;
+
+  if (opt_.fsync == FsyncPolicy::EveryBatch) sync_file_();
+  else maybe_sync_(now);
+}
+
+void AsyncLogger::maybe_sync_(int64_t now) {
+  if (opt_.fsync != FsyncPolicy::Interval || !unsynced_) return;
+  if (now - last_fsync_us_ < static_cast<int64_t>(opt_.fsync_interval_ms) * 1000) return;
+  sync_file_();
+  last_fsync_us_ = now;
+}
+
+void AsyncLogger::run_() {
+  std::string buf;
+  buf.reserve(kMaxBatchBytes + 4096);
+
+  for (;;) {
+    // running_ 을 먼저 읽어야 종료 직전에 들어온 레코드까지 비우고 나감
+    bool live = running_.load(std::memory_order_acquire);
+
+    uint64_t mono = mono_now_();
+    int64_t now = anchor_wall_us_ + static_cast<int64_t>(mono);
+
+    // 회전은 인코딩 전에: 바이너리 오프셋/id 사전이 이번 배치를 받을 파일 기준이어야 함
+    // (쓸 것이 있을 때만 -> 빈 파일을 만들지 않음)
+    uint64_t d = dropped_.load(std::memory_order_relaxed);
+    if (d != reported_drops_ || has_pending_()) roll_if_needed_(now);
+
+    buf.clear();
+    size_t n = drain_(buf);
+
+    if (d != reported_drops_) {
+      std::string msg = "[logger] dropped " + std::to_string(d - reported_drops_) + " records";
+      if (opt_.format == LogFormat::Binary) {
+        encode_(buf, LogRecord{LogEvent::System, {}, {}, msg}, mono);
+      } else {
+        buf += stamp_for_(now);
+        buf += msg;
+        buf += '\n';
+      }
+      reported_drops_ = d;
+    }
+
+    if (!buf.empty()) {
+      write_batch_(buf, now);
+      written_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    if (n == 0) {
+      if (!live) break;
+      maybe_sync_(now); // 조용해진 뒤에도 Interval 정책의 마지막 배치를 내림
+      std::this_thread::sleep_for(std::chrono::milliseconds(opt_.flush_interval_ms));
+    }
+  }
+
+  close_file_();
+}
+
+} // namespace core
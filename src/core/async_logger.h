@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/binlog_writer.h"
+#include "core/logger.h"
+
+namespace core {
+
+// 디스크 동기화 정책
+// - Never     : fflush 만 (OS 가 알아서 내림)
+// - EveryBatch: 배치를 쓸 때마다 fsync
+// - Interval  : fsync_interval_ms 마다 한 번
+enum class FsyncPolicy { Never, EveryBatch, Interval };
+
+// 파일 형식
+// - Text  : "[HH:MM:SS] [chat][room][nick] text" 한 줄씩 (<prefix>YYYYMMDD.txt)
+// - Binary: common/binlog_format.h (<prefix>YYYYMMDD.bin, chat_logcat 으로 조회)
+enum class LogFormat { Text, Binary };
+
+struct AsyncLoggerOptions {
+  std::string dir = "logs";
+  std::string prefix = "chat_";      // 파일명: <dir>/<prefix>YYYYMMDD[_N].txt|.bin
+  LogFormat format = LogFormat::Text;
+  size_t capacity = 16384;           // 링 슬롯 수 (2의 거듭제곱으로 올림)
+  size_t max_file_bytes = 0;         // 0 = 크기 회전 없음 (날짜 회전만). 배치 단위로 판정 (soft limit)
+  unsigned flush_interval_ms = 50;   // 링이 비었을 때 writer 가 쉬는 간격
+  FsyncPolicy fsync = FsyncPolicy::Interval;
+  unsigned fsync_interval_ms = 1000;
+};
+
+// 비동기 로거
+// - log() 는 어떤 경우에도 막히지 않음: MPSC 링에 기록만 하고, 가득 차면 버리고 dropped 증가
+// - 백그라운드 writer 가 모아서 한 번에 쓰고 정책에 따라 fsync
+// - 날짜가 바뀌거나 max_file_bytes 를 넘으면 새 파일로 회전
+class AsyncLogger {
+public:
+  explicit AsyncLogger(AsyncLoggerOptions opt = {});
+  ~AsyncLogger();
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  void log(const LogRecord& r);
+
+  // ChatCore 에 넘길 훅 (로거 수명은 shared_ptr 로 묶임)
+  static LogFn make_log_fn(const std::shared_ptr<AsyncLogger>& lg);
+
+  // 남은 레코드를 모두 쓰고 writer 종료 (여러 번 호출해도 됨)
+  void stop();
+
+  uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  uint64_t rotations() const { return rotations_.load(std::memory_order_relaxed); }
+
+private:
+  // Vyukov 방식 bounded 큐 슬롯: seq 로 소유권을 넘김 (생산자끼리도 CAS 만)
+  // 문자열은 writer 가 clear 만 하므로 용량이 재사용됨
+  struct Slot {
+    std::atomic<size_t> seq{0};
+    uint64_t mono_us = 0; // steady_clock - anchor (writer 가 벽시계로 환산)
+    LogEvent ev = LogEvent::System;
+    std::string room;
+    std::string nick;
+    std::string text;
+  };
+
+  AsyncLoggerOptions opt_;
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_ = 0;
+  alignas(64) std::atomic<size_t> head_{0}; // 생산자 쪽
+  alignas(64) size_t tail_ = 0;             // writer 전용
+
+  // 시각 기준점: 레코드 시각 = anchor_wall_us_ + mono_us (단조 증가)
+  int64_t anchor_wall_us_ = 0;
+  int64_t anchor_mono_us_ = 0;
+
+  std::atomic<bool> running_{false};
+  std::thread writer_;
+
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> rotations_{0};
+
+  // writer 전용 상태
+  std::FILE* fp_ = nullptr;
+  std::string day_;          // 현재 파일의 YYYYMMDD
+  unsigned part_ = 0;        // 같은 날짜 안에서의 크기 회전 번호
+  size_t file_bytes_ = 0;
+  int64_t last_sec_ = -1;    // 시각 문자열 캐시 (초 단위)
+  std::string stamp_;        // "[HH:MM:SS] "
+  int64_t last_fsync_us_ = 0;
+  bool unsynced_ = false;    // fflush 후 아직 fsync 안 된 쓰기가 있음
+  uint64_t reported_drops_ = 0;
+  BinLogWriter bin_;
+
+  void run_();
+  uint64_t mono_now_() const;
+  bool has_pending_() const;
+  size_t drain_(std::string& buf);
+  void encode_(std::string& buf, const LogRecord& r, uint64_t mono_us);
+  void roll_if_needed_(int64_t now_us);
+  void write_batch_(const std::string& buf, int64_t now_us);
+  void open_file_(int64_t now_us);
+  void close_file_();
+  void sync_file_();
+  void maybe_sync_(int64_t now_us);
+  const std::string& stamp_for_(int64_t ts_us);
+};
+
+} // namespace core
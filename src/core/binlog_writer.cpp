@@ -0,0 +1,113 @@
+#include "core/binlog_writer.h"
+#include "common/binlog_format.h"
+
+#include <algorithm>
+
+namespace core {
+
+namespace {
+
+void put_record(std::string& out, const std::string& body) {
+  binlog::put_varint(out, body.size());
+  out += body;
+}
+
+void add_unique(std::vector<uint32_t>& v, uint32_t id) {
+  if (id != 0 && std::find(v.begin(), v.end(), id) == v.end()) v.push_back(id);
+}
+
+} // namespace
+
+void BinLogWriter::begin(std::string& out, int64_t base_unix_us) {
+  rooms_.clear();
+  nicks_.clear();
+  prev_index_off_ = 0;
+
+  out.append(binlog::kMagic, sizeof(binlog::kMagic));
+  binlog::put_u64le(out, static_cast<uint64_t>(base_unix_us));
+  reset_block_(binlog::kHeaderSize);
+}
+
+void BinLogWriter::reset_block_(size_t off) {
+  block_off_ = off;
+  count_ = 0;
+  ts_min_ = ts_max_ = 0;
+  block_rooms_.clear();
+  block_nicks_.clear();
+  block_defs_.clear();
+}
+
+uint32_t BinLogWriter::intern_(std::string& out, uint32_t kind,
+                               std::unordered_map<std::string, uint32_t>& dict,
+                               std::string_view name) {
+  if (name.empty()) return 0;
+  auto it = dict.find(std::string(name));
+  if (it != dict.end()) return it->second;
+
+  uint32_t id = static_cast<uint32_t>(dict.size() + 1);
+  dict.emplace(std::string(name), id);
+
+  std::string body;
+  binlog::put_varint(body, kind);
+  binlog::put_varint(body, id);
+  body.append(name);
+  put_record(out, body);
+  block_defs_.push_back(Def{kind, id, std::string(name)});
+  return id;
+}
+
+void BinLogWriter::append(std::string& out, size_t file_off, const LogRecord& r, uint64_t ts_us) {
+  uint32_t room = intern_(out, binlog::kDefRoom, rooms_, r.room);
+  uint32_t nick = intern_(out, binlog::kDefNick, nicks_, r.nick);
+
+  std::string body;
+  body.reserve(16 + r.text.size());
+  binlog::put_varint(body, static_cast<uint32_t>(r.ev));
+  binlog::put_varint(body, ts_us);
+  binlog::put_varint(body, room);
+  binlog::put_varint(body, nick);
+  body.append(r.text);
+  put_record(out, body);
+
+  if (count_ == 0 || ts_us < ts_min_) ts_min_ = ts_us;
+  if (count_ == 0 || ts_us > ts_max_) ts_max_ = ts_us;
+  add_unique(block_rooms_, room);
+  add_unique(block_nicks_, nick);
+  if (++count_ >= kIndexEvery) write_index_(out, file_off);
+}
+
+void BinLogWriter::write_index_(std::string& out, size_t file_off) {
+  size_t index_off = file_off + out.size();
+
+  std::string body;
+  binlog::put_varint(body, binlog::kIndex);
+  binlog::put_varint(body, prev_index_off_);
+  binlog::put_varint(body, block_off_);
+  binlog::put_varint(body, index_off - block_off_);
+  binlog::put_varint(body, count_);
+  binlog::put_varint(body, ts_min_);
+  binlog::put_varint(body, ts_max_);
+  binlog::put_varint(body, block_rooms_.size());
+  for (uint32_t id : block_rooms_) binlog::put_varint(body, id);
+  binlog::put_varint(body, block_nicks_.size());
+  for (uint32_t id : block_nicks_) binlog::put_varint(body, id);
+  binlog::put_varint(body, block_defs_.size());
+  for (const Def& d : block_defs_) {
+    binlog::put_varint(body, d.kind);
+    binlog::put_varint(body, d.id);
+    binlog::put_varint(body, d.name.size());
+    body += d.name;
+  }
+  put_record(out, body);
+
+  prev_index_off_ = index_off;
+  reset_block_(file_off + out.size());
+}
+
+void BinLogWriter::finish(std::string& out, size_t file_off) {
+  if (count_ > 0 || !block_defs_.empty() || prev_index_off_ == 0) write_index_(out, file_off);
+  binlog::put_u64le(out, prev_index_off_);
+  out.append(binlog::kFooterMagic, sizeof(binlog::kFooterMagic));
+}
+
+} // namespace core
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "core/logger.h"
+
+namespace core {
+
+// 바이너리 로그 인코더 (포맷은 common/binlog_format.h)
+// - 파일 하나 = begin() ... finish(); 방/닉 id 사전은 파일마다 새로 시작
+// - out 은 파일 끝(file_off)에 그대로 이어 붙일 바이트; 오프셋 계산에 file_off 사용
+// - 스레드 안전하지 않음: 로거 writer 스레드 전용
+class BinLogWriter {
+public:
+  static constexpr size_t kIndexEvery = 4096; // 이벤트 N 개마다 인덱스 블록
+
+  void begin(std::string& out, int64_t base_unix_us);
+  void append(std::string& out, size_t file_off, const LogRecord& r, uint64_t ts_us);
+  // 남은 블록의 인덱스 + 푸터
+  void finish(std::string& out, size_t file_off);
+
+private:
+  struct Def {
+    uint32_t kind;
+    uint32_t id;
+    std::string name;
+  };
+
+  std::unordered_map<std::string, uint32_t> rooms_;
+  std::unordered_map<std::string, uint32_t> nicks_;
+
+  // 현재 블록 요약
+  size_t block_off_ = 0;
+  size_t count_ = 0;
+  uint64_t ts_min_ = 0;
+  uint64_t ts_max_ = 0;
+  std::vector<uint32_t> block_rooms_;
+  std::vector<uint32_t> block_nicks_;
+  std::vector<Def> block_defs_;
+  size_t prev_index_off_ = 0;
+
+  uint32_t intern_(std::string& out, uint32_t kind,
+                   std::unordered_map<std::string, uint32_t>& dict, std::string_view name);
+  void write_index_(std::string& out, size_t file_off);
+  void reset_block_(size_t off);
+};
+
+} // namespace core
@@ -1,232 +1,659 @@
 #include "core/chat_core.h"
 #include "core/protocol.h"
+#include "core/request_decoder.h"
+#include "common/json_io.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 using nlohmann::json;
 
 namespace core {
 
-ChatCore::ChatCore(LogFn logger) : log_(std::move(logger)) {}
+ChatCore::ChatCore(LogFn logger, HistoryLimits history, std::shared_ptr<SegmentStore> store,
+                   CompressOptions compress, std::shared_ptr<Keepalive> keepalive)
+  : lobby_(syms_.intern("lobby")), guest_(syms_.intern("guest")),
+    hist_(history), hist_budget_(history.global_max_bytes), log_(std::move(logger)),
+    store_(std::move(store)), keepalive_(std::move(keepalive)) {
+  z_.opt = compress;
+  if (!zcodec::supported()) z_.opt.enabled = false;
+}
+
+void ChatCore::log_event(LogEvent ev, std::string_view room, std::string_view nick,
+                         std::string_view text) {
+  if (log_) log_(LogRecord{ev, room, nick, text});
+}
+
+ChatCore::ClientPtr ChatCore::find_client(const std::string& id) {
+  std::shared_lock<std::shared_mutex> lk(clients_mx_);
+  auto it = clients_.find(id);
+  return it == clients_.end() ? nullptr : it->second;
+}
+
+ChatCore::RoomPtr ChatCore::get_room(const Symbol& name) {
+  sweep_emptied_rooms();
+  if (!store_) {
+    std::lock_guard<std::mutex> lk(rooms_mx_);
+    auto& slot = rooms_[name.id()];
+    if (!slot) slot = std::make_shared<Room>(name, hist_, &hist_budget_);
+    return slot;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(rooms_mx_);
+    auto it = rooms_.find(name.id());
+    if (it != rooms_.end()) return it->second;
+  }
+  // 디스크 읽기는 rooms_mx_ 밖에서; 동시에 만든 쪽이 있으면 먼저 등록된 방을 씀
+  auto fresh = std::make_shared<Room>(name, hist_, &hist_budget_);
+  restore_room(*fresh);
+  std::lock_guard<std::mutex> lk(rooms_mx_);
+  auto& slot = rooms_[name.id()];
+  if (!slot) slot = std::move(fresh);
+  return slot;
+}
+
+void ChatCore::restore_room(Room& r) {
+  // 아직 공유 전이지만 ring 에 항목이 생기면 HistoryBudget 이 다른 스레드에서 이 락으로 접근함
+  std::lock_guard<std::mutex> lk(r.mx);
+  r.log = store_->open(r.name.str());
+  r.next_seq = store_->last_seq(r.log) + 1;
+  store_->read_before(r.log, UINT64_MAX, hist_.max_msgs,
+                      [&](uint64_t seq, int64_t, std::string_view payload) {
+                        r.history.append(seq, std::make_shared<const Frame>(payload));
+                      });
+}
 
-void ChatCore::log_line(const std::string& s) {
-  if (log_) log_(s);
+void ChatCore::release_room(const RoomPtr& r) {
+  std::lock_guard<std::mutex> lk(rooms_mx_);
+  std::lock_guard<std::mutex> rlk(r->mx);
+  if (!r->members.empty() || !r->history.empty() || r->dead) return;
+  r->dead = true;
+  auto it = rooms_.find(r->name.id());
+  if (it != rooms_.end() && it->second == r) rooms_.erase(it);
 }
 
-bool ChatCore::nick_taken_locked(const std::string& nick) const {
-  for (const auto& [_, c] : clients_) {
-    if (c.nick == nick) return true;
+void ChatCore::sweep_emptied_rooms() {
+  for (SymId id : hist_budget_.take_emptied()) {
+    RoomPtr r;
+    {
+      std::lock_guard<std::mutex> lk(rooms_mx_);
+      auto it = rooms_.find(id);
+      if (it == rooms_.end()) continue;
+      r = it->second;
+    }
+    release_room(r); // 그 사이 멤버/기록이 생겼으면 그대로 둠
   }
-  return false;
 }
 
-std::string ChatCore::make_unique_nick_locked(const std::string& base) const {
-  if (!nick_taken_locked(base)) return base;
-  for (int i = 2; i <= 9999; i++) {
-    std::string cand = base + "_" + std::to_string(i);
-    if (!nick_taken_locked(cand)) return cand;
+Symbol ChatCore::register_nick(Client& cl, const std::string& requested) {
+  std::string assigned;
+  {
+    std::lock_guard<std::mutex> lk(nick_mx_);
+    nicks_.release(cl.nick_h);
+    cl.nick_h = nicks_.acquire(requested);
+    assigned = cl.nick_h.nick;
   }
-  return base + "_" + std::to_string(std::rand() % 100000);
+  return syms_.intern(assigned);
+}
+
+void ChatCore::room_add_locked(Room& r, Client& cl) {
+  cl.room_slot = r.members.size();
+  r.members.push_back(&cl);
+}
+
+void ChatCore::room_remove_locked(Room& r, Client& cl) {
+  auto& members = r.members;
+  if (cl.room_slot >= members.size() || members[cl.room_slot] != &cl) return;
+
+  // swap-remove: 마지막 멤버를 빈 자리로 옮김
+  Client* last = members.back();
+  members[cl.room_slot] = last;
+  last->room_slot = cl.room_slot;
+  members.pop_back();
 }
 
-void ChatCore::send_error(const ConnPtr& c, const std::string& req_id,
+void ChatCore::send_error(const ConnPtr& c, std::string_view req_id,
                           const std::string& code, const std::string& text) {
   if (!c) return;
-  (void)c->send(proto::make_error(req_id, code, text));
+  (void)c->enqueue(proto::make_error(req_id, code, text), MsgClass::System);
+}
+
+void ChatCore::fail(Client& me, const ConnPtr& c, std::string_view req_id,
+                    const std::string& code, const std::string& text) {
+  if (me.item_err) {
+    if (!me.item_err->failed) *me.item_err = ItemError{true, code, text};
+    return;
+  }
+  send_error(c, req_id, code, text);
 }
 
 void ChatCore::on_connect(const ConnPtr& c) {
   if (!c) return;
-  std::lock_guard<std::mutex> lk(mx_);
 
-  Client cl;
-  cl.conn = c;
-  cl.nick = "guest";
-  cl.room = "lobby";
-  cl.hello = false;
-  clients_[c->id()] = cl;
+  auto cl = std::make_shared<Client>();
+  cl->conn = c;
+  cl->nick = guest_;
+  {
+    std::unique_lock<std::shared_mutex> lk(clients_mx_);
+    clients_[c->id()] = cl;
+  }
+
+  // 조회와 락 사이에 방이 비워져 제거됐으면 다시 조회
+  for (;;) {
+    RoomPtr r = get_room(lobby_);
+    std::lock_guard<std::mutex> lk(r->mx);
+    if (r->dead) continue;
+    cl->room = r;
+    room_add_locked(*r, *cl);
+    break;
+  }
 
-  log_line("[connect] " + c->id());
+  if (keepalive_) keepalive_->add(c);
+  log_event(LogEvent::Connect, {}, {}, c->id());
 }
 
 void ChatCore::on_disconnect(const ConnPtr& c) {
   if (!c) return;
+  if (keepalive_) keepalive_->remove(c.get());
 
-  std::string nick;
-  std::string room;
-
+  ClientPtr cl;
   {
-    std::lock_guard<std::mutex> lk(mx_);
+    std::unique_lock<std::shared_mutex> lk(clients_mx_);
     auto it = clients_.find(c->id());
-    if (it != clients_.end()) {
-      nick = it->second.nick;
-      room = it->second.room;
+    if (it != clients_.end() && it->second->conn == c) {
+      cl = std::move(it->second);
       clients_.erase(it);
     }
   }
 
-  if (!nick.empty()) {
-    std::lock_guard<std::mutex> lk(mx_);
-    send_system_to_room_locked(room, nick + " disconnected");
+  if (cl) {
+    RoomPtr r = cl->room;
+    if (r) {
+      std::lock_guard<std::mutex> lk(r->mx);
+      room_remove_locked(*r, *cl);
+      send_system_to_room_locked(*r, cl->nick.str() + " disconnected", cl->nick.str());
+    }
+    {
+      std::lock_guard<std::mutex> lk(nick_mx_);
+      nicks_.release(cl->nick_h);
+    }
+    if (r) release_room(r);
   }
 
-  log_line("[disconnect] " + c->id());
+  log_event(LogEvent::Disconnect, {}, {}, c->id());
 }
 
-void ChatCore::send_system_to_room_locked(const std::string& room, const std::string& text) {
-  std::vector<std::string> dead;
-  for (auto& [id, cl] : clients_) {
-    if (cl.room != room) continue;
-    if (!cl.conn || !cl.conn->send(proto::make_system(text))) {
-      dead.push_back(id);
-    }
+// 팬아웃 중 enqueue 에 실패한 연결은 close 만 한다.
+// 트랜스포트가 읽기 종료를 감지해 on_disconnect 를 부르면 그때 방/목록에서 빠진다.
+// (다른 방이나 공유 상태를 건드리지 않아 방 락 하나로 끝남)
+void ChatCore::send_system_to_room_locked(Room& r, std::string_view text,
+                                          std::string_view subject) {
+  // 한 번만 직렬화하고 모든 수신자가 같은 프레임을 공유
+  FramePtr frame = Frame::from_json(proto::make_system(text));
+
+  for (Client* cl : r.members) {
+    if (cl->conn && !cl->conn->enqueue(frame, MsgClass::System)) cl->conn->close();
   }
-  for (auto& id : dead) {
-    auto it = clients_.find(id);
-    if (it != clients_.end()) {
-      if (it->second.conn) it->second.conn->close();
-      clients_.erase(it);
-    }
+  log_event(LogEvent::System, r.name.str(), subject, text);
+}
+
+void ChatCore::broadcast_chat_to_room_locked(Room& r, const Symbol& from,
+                                             std::string_view text) {
+  FramePtr frame = append_chat_locked(r, from, text);
+  for (Client* cl : r.members) {
+    if (cl->conn && !cl->conn->enqueue(frame, MsgClass::Chat)) cl->conn->close();
+  }
+}
+
+FramePtr ChatCore::append_chat_locked(Room& r, const Symbol& from, std::string_view text) {
+  const uint64_t seq = r.next_seq++;
+  FramePtr frame = Frame::from_json(proto::make_chat(r.name.str(), from.str(), text, seq),
+                                    Encoding::Json, r.dict);
+  r.history.append(seq, frame);
+  if (store_) {
+    using namespace std::chrono;
+    const int64_t now_us =
+      duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+    store_->append(r.log, seq, now_us, frame->text());
   }
-  log_line("[system][" + room + "] " + text);
+  if (z_.opt.enabled && z_.opt.room_dict && !r.dict) train_dict_locked(r, frame->text());
+  log_event(LogEvent::Chat, r.name.str(), from.str(), text);
+  return frame;
 }
 
-void ChatCore::broadcast_chat_to_room_locked(const std::string& room,
-                                             const std::string& from,
-                                             const std::string& text) {
-  json msg = proto::make_chat(room, from, text);
+namespace {
+
+// batch_ok 결과: req_id 가 있거나 실패한 하위 요청만 남김
+void add_item_result(json& results, size_t& failed, size_t i, std::string_view req_id,
+                     bool ok, const std::string& code = {}, const std::string& text = {}) {
+  if (ok && req_id.empty()) return;
+  json r = {{"i", i}, {"ok", ok}};
+  if (!req_id.empty()) r["req_id"] = req_id;
+  if (!ok) {
+    r["code"] = code;
+    r["text"] = text;
+    failed++;
+  }
+  results.push_back(std::move(r));
+}
 
-  std::vector<std::string> dead;
-  for (auto& [id, cl] : clients_) {
-    if (cl.room != room) continue;
-    if (!cl.conn || !cl.conn->send(msg)) {
-      dead.push_back(id);
+} // namespace
+
+bool ChatCore::send_frames(const ConnPtr& c, const std::vector<FramePtr>& frames,
+                           const FramePtr& batch) {
+  if (batch) {
+    if (c->enqueue(batch, MsgClass::Chat)) return true;
+    c->close();
+    return false;
+  }
+  for (const FramePtr& f : frames) {
+    if (!c->enqueue(f, MsgClass::Chat)) {
+      c->close();
+      return false;
     }
   }
-  for (auto& id : dead) {
-    auto it = clients_.find(id);
-    if (it != clients_.end()) {
-      if (it->second.conn) it->second.conn->close();
-      clients_.erase(it);
+  return true;
+}
+
+void ChatCore::fanout_chats_locked(Room& r, const std::vector<FramePtr>& frames) {
+  if (frames.empty()) return;
+  FramePtr batch;
+  bool built = false;
+  for (Client* cl : r.members) {
+    if (!cl->conn) continue;
+    if (cl->batch_rx && !built) {
+      batch = Frame::batch(frames, r.dict);
+      built = true;
     }
+    send_frames(cl->conn, frames, cl->batch_rx ? batch : nullptr);
   }
-  log_line("[chat][" + room + "][" + from + "] " + text);
 }
 
-void ChatCore::handle_who_locked(const ConnPtr& c, const std::string& req_id) {
-  if (!c) return;
-  auto it = clients_.find(c->id());
-  if (it == clients_.end()) return;
+void ChatCore::train_dict_locked(Room& r, std::string_view payload) {
+  if (!r.trainer) r.trainer = std::make_unique<DictTrainer>(z_.opt);
+  r.trainer->add(payload);
+  if (!r.trainer->ready()) return;
 
-  const std::string room = it->second.room;
+  r.dict = r.trainer->build();
+  r.trainer.reset();
+  z_.stats.dicts.fetch_add(1, std::memory_order_relaxed);
+  for (Client* cl : r.members) send_dict_locked(r, cl->conn);
+}
+
+void ChatCore::send_dict_locked(Room& r, const ConnPtr& c) {
+  if (!r.dict || !c || !c->compression()) return;
+  if (!c->enqueue(proto::make_dict(r.name.str(), r.dict->id, r.dict->bytes), MsgClass::System)) {
+    c->close();
+  }
+}
+
+void ChatCore::handle_who_locked(Room& r, const ConnPtr& c, std::string_view req_id) {
+  if (!c) return;
   json users = json::array();
-  for (auto& [_, cl] : clients_) {
-    if (cl.room == room) users.push_back(cl.nick);
+  for (const Client* cl : r.members) users.push_back(cl->nick.str());
+
+  if (!c->enqueue(proto::make_who_ok(req_id, r.name.str(), users), MsgClass::System)) {
+    // 연결이 죽었으면 닫음 (정리는 on_disconnect 에서)
+    c->close();
   }
+}
+
+bool ChatCore::send_history_locked(Room& r, const Client& to, std::string_view req_id,
+                                   uint64_t before, size_t limit, bool explicit_req) {
+  const ConnPtr& c = to.conn;
+  if (!c) return true;
+  std::vector<FramePtr> frames;
+  uint64_t first = 0;
+  bool more = false;
+  size_t n = r.history.collect(before, limit, frames, first, more);
+  if (n == 0 && !explicit_req) return true;
+
+  if (explicit_req && store_ && n < limit && !more) {
+    // ring 이 모자람: store 에 더 오래된 것이 있으면 이 페이지 전체를 거기서 (락 밖에서)
+    const uint64_t oldest = store_->first_seq(r.log);
+    if (oldest && (n == 0 || first > oldest)) return false;
+  }
+
+  // 보관된 프레임을 그대로 공유 (재직렬화 없음)
+  if (!send_frames(c, frames, to.batch_rx ? Frame::batch(frames, r.dict) : nullptr)) return true;
+  (void)c->enqueue(proto::make_history_ok(req_id, r.name.str(), n, first, more), MsgClass::System);
+  return true;
+}
+
+void ChatCore::send_store_before(const Room& r, const Client& to, std::string_view req_id,
+                                 uint64_t before, size_t limit, const zcodec::DictPtr& dict) {
+  const ConnPtr& c = to.conn;
+  if (!c) return;
+  std::vector<FramePtr> frames;
+  uint64_t first = 0;
+  // mmap 된 세그먼트(보통 page cache) + 아직 쓰기 전 버퍼
+  size_t n = store_->read_before(r.log, before, limit,
+                                 [&](uint64_t seq, int64_t, std::string_view payload) {
+                                   if (!first) first = seq;
+                                   frames.push_back(std::make_shared<const Frame>(payload));
+                                 });
+  const bool more = n > 0 && first > store_->first_seq(r.log);
+  if (!send_frames(c, frames, to.batch_rx ? Frame::batch(frames, dict) : nullptr)) return;
+  (void)c->enqueue(proto::make_history_ok(req_id, r.name.str(), n, first, more), MsgClass::System);
+}
 
-  if (!c->send(proto::make_who_ok(req_id, room, users))) {
-    // 연결이 죽었으면 제거
-    auto it2 = clients_.find(c->id());
-    if (it2 != clients_.end()) {
-      if (it2->second.conn) it2->second.conn->close();
-      clients_.erase(it2);
+void ChatCore::send_store_since(const Room& r, const Client& to, std::string_view req_id,
+                                int64_t since_us, size_t limit, const zcodec::DictPtr& dict) {
+  const ConnPtr& c = to.conn;
+  if (!c) return;
+  std::vector<FramePtr> frames;
+  uint64_t first = 0;
+  size_t n = store_->read_since(r.log, since_us, limit,
+                                [&](uint64_t seq, int64_t, std::string_view payload) {
+                                  if (!first) first = seq;
+                                  frames.push_back(std::make_shared<const Frame>(payload));
+                                });
+  if (!send_frames(c, frames, to.batch_rx ? Frame::batch(frames, dict) : nullptr)) return;
+  const bool more = n > 0 && first > store_->first_seq(r.log);
+  (void)c->enqueue(proto::make_history_ok(req_id, r.name.str(), n, first, more), MsgClass::System);
+}
+
+void ChatCore::handle_join(Client& me, std::string_view new_room) {
+  RoomPtr old = me.room;
+  const Symbol name = syms_.intern(new_room);
+
+  for (;;) {
+    RoomPtr nr = get_room(name);
+
+    if (nr == old) {
+      // 같은 방 재입장: 기존 동작대로 left/joined 를 모두 알림
+      std::lock_guard<std::mutex> lk(nr->mx);
+      send_system_to_room_locked(*nr, me.nick.str() + " left " + nr->name.str(), me.nick.str());
+      send_history_locked(*nr, me, "", UINT64_MAX, hist_.replay_msgs, false);
+      send_system_to_room_locked(*nr, me.nick.str() + " joined " + nr->name.str(),
+                                 me.nick.str());
+      return;
     }
+
+    // 두 방을 동시에 잡아 이동과 알림이 양쪽 방의 순서 안에서 일어나게 함
+    std::scoped_lock lk(old->mx, nr->mx);
+    if (nr->dead) continue;
+
+    room_remove_locked(*old, me);
+    room_add_locked(*nr, me);
+    me.room = nr;
+    send_system_to_room_locked(*old, me.nick.str() + " left " + old->name.str(), me.nick.str());
+    send_dict_locked(*nr, me.conn);
+    send_history_locked(*nr, me, "", UINT64_MAX, hist_.replay_msgs, false);
+    send_system_to_room_locked(*nr, me.nick.str() + " joined " + nr->name.str(), me.nick.str());
+    break;
   }
+
+  release_room(old);
 }
 
+const std::array<ChatCore::Handler, static_cast<size_t>(proto::MsgType::Count)>
+ChatCore::handlers_ = [] {
+  using proto::MsgType;
+  std::array<Handler, static_cast<size_t>(MsgType::Count)> h{};
+  h[static_cast<size_t>(MsgType::Hello)] = &ChatCore::on_hello;
+  h[static_cast<size_t>(MsgType::Chat)] = &ChatCore::on_chat;
+  h[static_cast<size_t>(MsgType::Join)] = &ChatCore::on_join;
+  h[static_cast<size_t>(MsgType::Nick)] = &ChatCore::on_nick;
+  h[static_cast<size_t>(MsgType::Who)] = &ChatCore::on_who;
+  h[static_cast<size_t>(MsgType::History)] = &ChatCore::on_history;
+  h[static_cast<size_t>(MsgType::Batch)] = &ChatCore::on_batch;
+  h[static_cast<size_t>(MsgType::Pong)] = &ChatCore::on_pong;
+  return h;
+}();
+
 void ChatCore::on_message(const ConnPtr& c, const json& j) {
   if (!c) return;
+  // 필드는 한 번에 뽑아 view 로 들고 다님 (type/req_id 복사 없음)
+  dispatch(c, proto::parse_request(j));
+}
+
+bool ChatCore::on_frame(const ConnPtr& c, std::string_view payload) {
+  if (!c) return true;
+
+  // v2(MessagePack) 는 협상과 무관하게 프레임마다 첫 바이트로 구분
+  if (jsonio::is_msgpack(payload)) {
+    json j;
+    if (!jsonio::parse_msgpack(payload, j)) return false;
+    on_message(c, j);
+    return true;
+  }
 
-  const std::string t = proto::type(j);
-  const std::string rid = proto::req_id(j);
+  proto::Request m;
+  if (proto::decode_request(payload, m)) {
+    dispatch(c, m);
+    return true;
+  }
+  json j;
+  if (!jsonio::parse_json(payload, j)) return false;
+  on_message(c, j);
+  return true;
+}
 
-  std::lock_guard<std::mutex> lk(mx_);
-  auto it = clients_.find(c->id());
-  if (it == clients_.end()) return;
+void ChatCore::dispatch(const ConnPtr& c, const proto::Request& m) {
+  // 공유 락은 조회하는 동안만; 이후는 방 락 또는 무락
+  ClientPtr cl = find_client(c->id());
+  if (!cl) return;
+  c->mark_rx();
 
-  Client& me = it->second;
+  Client& me = *cl;
 
-  if (t.empty()) {
-    send_error(c, rid, "BAD_REQ", "missing type");
+  if (m.type_name.empty()) {
+    send_error(c, m.req_id, "BAD_REQ", "missing type");
     return;
   }
 
   // hello before anything
-  if (!me.hello && t != "hello") {
-    send_error(c, rid, "BAD_STATE", "send hello first");
+  if (!me.hello && m.type != proto::MsgType::Hello && m.type != proto::MsgType::Pong) {
+    send_error(c, m.req_id, "BAD_STATE", "send hello first");
     return;
   }
 
-  if (t == "hello") {
-    if (!j.contains("nick") || !j["nick"].is_string()) {
-      send_error(c, rid, "BAD_REQ", "hello requires nick");
-      return;
-    }
-    std::string requested = j["nick"].get<std::string>();
-    if (requested.empty() || requested.size() > 20) {
-      send_error(c, rid, "BAD_REQ", "invalid nick");
-      return;
-    }
-    std::string assigned = make_unique_nick_locked(requested);
-    me.nick = assigned;
-    me.hello = true;
+  Handler h = handlers_[static_cast<size_t>(m.type)];
+  if (!h) {
+    send_error(c, m.req_id, "BAD_REQ", "unknown type: " + std::string(m.type_name));
+    return;
+  }
+  (this->*h)(me, c, m);
+}
 
-    (void)c->send(proto::make_hello_ok(rid, assigned, me.room));
-    send_system_to_room_locked(me.room, assigned + " joined " + me.room);
+void ChatCore::on_hello(Client& me, const ConnPtr& c, const proto::Request& m) {
+  if (!m.nick) {
+    fail(me, c, m.req_id, "BAD_REQ", "hello requires nick");
+    return;
+  }
+  if (m.nick->empty() || m.nick->size() > 20) {
+    fail(me, c, m.req_id, "BAD_REQ", "invalid nick");
     return;
   }
+  Symbol assigned = register_nick(me, std::string(*m.nick));
+
+  // v2: 인코딩 협상. 모르는 값이면 JSON (hello_ok 의 enc 로 확정값을 알림)
+  const bool v2 = m.v >= 2;
+  const Encoding enc = v2 && m.enc && *m.enc == encoding_name(Encoding::MsgPack)
+    ? Encoding::MsgPack : Encoding::Json;
+  // 압축: 서버가 켜 뒀고 transport 가 플래그를 실을 수 있을 때만 (거절하면 hello_ok 에 없음)
+  const bool deflate = m.compress && *m.compress == "deflate" && z_.opt.enabled &&
+                       c->can_compress();
+
+  Room& r = *me.room;
+  std::lock_guard<std::mutex> lk(r.mx);
+  me.nick = assigned;
+  me.hello = true;
+  me.batch_rx = m.batch.value_or(false);
+  c->set_batch_rx(me.batch_rx);
+  (void)c->enqueue(proto::make_hello_ok(m.req_id, assigned.str(), r.name.str(),
+                                        v2 ? encoding_name(enc) : "",
+                                        deflate ? "deflate" : ""),
+                   MsgClass::System);
+  // hello_ok 는 기존 인코딩으로, 그 뒤 프레임부터 새 인코딩/압축
+  // (방 락 안이라 이 방의 팬아웃과 순서가 섞이지 않음)
+  c->set_encoding(enc);
+  c->set_compression(deflate ? &z_ : nullptr);
+  send_dict_locked(r, c);
+  send_history_locked(r, me, "", UINT64_MAX, hist_.replay_msgs, false);
+  send_system_to_room_locked(r, assigned.str() + " joined " + r.name.str(), assigned.str());
+}
 
-  if (t == "chat") {
-    if (!j.contains("text") || !j["text"].is_string()) {
-      send_error(c, rid, "BAD_REQ", "chat requires text");
-      return;
-    }
-    std::string text = j["text"].get<std::string>();
-    if (text.empty()) return;
-    broadcast_chat_to_room_locked(me.room, me.nick, text);
+void ChatCore::on_chat(Client& me, const ConnPtr& c, const proto::Request& m) {
+  if (!m.text) {
+    fail(me, c, m.req_id, "BAD_REQ", "chat requires text");
     return;
   }
+  if (m.text->empty()) return;
+  Room& r = *me.room;
+  std::lock_guard<std::mutex> lk(r.mx);
+  broadcast_chat_to_room_locked(r, me.nick, *m.text);
+}
 
-  if (t == "join") {
-    if (!j.contains("room") || !j["room"].is_string()) {
-      send_error(c, rid, "BAD_REQ", "join requires room");
+void ChatCore::on_join(Client& me, const ConnPtr& c, const proto::Request& m) {
+  if (!m.room) {
+    fail(me, c, m.req_id, "BAD_REQ", "join requires room");
+    return;
+  }
+  if (m.room->empty() || m.room->size() > 30) {
+    fail(me, c, m.req_id, "BAD_REQ", "invalid room");
+    return;
+  }
+  handle_join(me, *m.room);
+}
+
+void ChatCore::on_nick(Client& me, const ConnPtr& c, const proto::Request& m) {
+  if (!m.nick) {
+    fail(me, c, m.req_id, "BAD_REQ", "nick requires nick");
+    return;
+  }
+  if (m.nick->empty() || m.nick->size() > 20) {
+    fail(me, c, m.req_id, "BAD_REQ", "invalid nick");
+    return;
+  }
+  Symbol nn = register_nick(me, std::string(*m.nick));
+
+  Room& r = *me.room;
+  std::lock_guard<std::mutex> lk(r.mx);
+  Symbol old = std::move(me.nick);
+  me.nick = nn;
+  send_system_to_room_locked(r, old.str() + " is now " + nn.str(), nn.str());
+}
+
+void ChatCore::on_pong(Client&, const ConnPtr&, const proto::Request&) {}
+
+void ChatCore::on_who(Client& me, const ConnPtr& c, const proto::Request& m) {
+  Room& r = *me.room;
+  std::lock_guard<std::mutex> lk(r.mx);
+  handle_who_locked(r, c, m.req_id);
+}
+
+void ChatCore::on_history(Client& me, const ConnPtr& c, const proto::Request& m) {
+  // before 생략 = 최신부터. limit 은 page_msgs 로 자름
+  // since(unix ms) = 그 시각 이후부터 (store 가 있을 때만)
+  uint64_t before = UINT64_MAX;
+  size_t limit = hist_.page_msgs;
+  if (m.before.present) {
+    if (!m.before.ok) {
+      fail(me, c, m.req_id, "BAD_REQ", "history before must be a seq");
       return;
     }
-    std::string new_room = j["room"].get<std::string>();
-    if (new_room.empty() || new_room.size() > 30) {
-      send_error(c, rid, "BAD_REQ", "invalid room");
+    before = m.before.value;
+  }
+  if (m.limit.present) {
+    if (!m.limit.ok || m.limit.value == 0) {
+      fail(me, c, m.req_id, "BAD_REQ", "history limit must be a positive number");
       return;
     }
-
-    std::string old = me.room;
-    me.room = new_room;
-    send_system_to_room_locked(old, me.nick + " left " + old);
-    send_system_to_room_locked(new_room, me.nick + " joined " + new_room);
-    return;
+    limit = static_cast<size_t>(std::min<uint64_t>(limit, m.limit.value));
   }
-
-  if (t == "nick") {
-    if (!j.contains("nick") || !j["nick"].is_string()) {
-      send_error(c, rid, "BAD_REQ", "nick requires nick");
+  if (m.since.present) {
+    if (!m.since.ok) {
+      fail(me, c, m.req_id, "BAD_REQ", "history since must be unix ms");
       return;
     }
-    std::string requested = j["nick"].get<std::string>();
-    if (requested.empty() || requested.size() > 20) {
-      send_error(c, rid, "BAD_REQ", "invalid nick");
+    if (!store_) {
+      fail(me, c, m.req_id, "BAD_REQ", "history since needs persistent history");
       return;
     }
-    std::string old = me.nick;
-    std::string nn = make_unique_nick_locked(requested);
-    me.nick = nn;
-    send_system_to_room_locked(me.room, old + " is now " + nn);
+    const int64_t since_us = static_cast<int64_t>(m.since.value) * 1000;
+    Room& r = *me.room;
+    zcodec::DictPtr dict;
+    {
+      std::lock_guard<std::mutex> lk(r.mx);
+      dict = r.dict;
+    }
+    send_store_since(r, me, m.req_id, since_us, limit, dict);
     return;
   }
+  Room& r = *me.room;
+  zcodec::DictPtr dict;
+  {
+    std::lock_guard<std::mutex> lk(r.mx);
+    if (send_history_locked(r, me, m.req_id, before, limit, true)) return;
+    dict = r.dict;
+  }
+  // 디스크 읽기는 방 락 밖에서 (팬아웃과 섞여 도착할 수 있음: 클라이언트는 seq 로 정렬)
+  send_store_before(r, me, m.req_id, before, limit, dict);
+}
 
-  if (t == "who") {
-    handle_who_locked(c, rid);
+void ChatCore::on_batch(Client& me, const ConnPtr& c, const proto::Request& m) {
+  if (!m.items || !m.items->is_array()) {
+    fail(me, c, m.req_id, "BAD_REQ", "batch requires items array");
     return;
   }
+  const json& items = *m.items;
+  if (items.size() > proto::kMaxBatchItems) {
+    fail(me, c, m.req_id, "BAD_REQ", "batch too large");
+    return;
+  }
+
+  json results = json::array();
+  size_t failed = 0;
+  for (size_t i = 0; i < items.size();) {
+    proto::Request sub = proto::parse_request(items[i]);
+    if (sub.type == proto::MsgType::Chat) {
+      i = batch_chat_run(me, items, i, results, failed);
+      continue;
+    }
 
-  send_error(c, rid, "BAD_REQ", "unknown type: " + t);
+    ItemError err;
+    Handler h = handlers_[static_cast<size_t>(sub.type)];
+    if (sub.type_name.empty()) {
+      err = ItemError{true, "BAD_REQ", "missing type"};
+    } else if (!h) {
+      err = ItemError{true, "BAD_REQ", "unknown type: " + std::string(sub.type_name)};
+    } else if (sub.type == proto::MsgType::Hello || sub.type == proto::MsgType::Batch) {
+      err = ItemError{true, "BAD_REQ", std::string(sub.type_name) + " not allowed in batch"};
+    } else {
+      me.item_err = &err;
+      (this->*h)(me, c, sub);
+      me.item_err = nullptr;
+    }
+    add_item_result(results, failed, i, sub.req_id, !err.failed, err.code, err.text);
+    i++;
+  }
+  (void)c->enqueue(proto::make_batch_ok(m.req_id, items.size(), failed, std::move(results)),
+                   MsgClass::System);
+}
+
+size_t ChatCore::batch_chat_run(Client& me, const json& items, size_t i,
+                                json& results, size_t& failed) {
+  Room& r = *me.room;
+  std::vector<FramePtr> frames;
+  std::lock_guard<std::mutex> lk(r.mx);
+  for (; i < items.size(); i++) {
+    proto::Request sub = proto::parse_request(items[i]);
+    if (sub.type != proto::MsgType::Chat) break;
+    if (!sub.text) {
+      add_item_result(results, failed, i, sub.req_id, false, "BAD_REQ", "chat requires text");
+      continue;
+    }
+    if (!sub.text->empty()) {
+      frames.push_back(append_chat_locked(r, me.nick, *sub.text));
+    }
+    add_item_result(results, failed, i, sub.req_id, true);
+  }
+  fanout_chats_locked(r, frames);
+  return i;
 }
 
 } // namespace core
@@ -1,47 +1,203 @@
 #pragma once
+#include <array>
+#include <atomic>
 #include <unordered_map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <vector>
+#include "core/compression.h"
 #include "core/connection.h"
+#include "core/keepalive.h"
 #include "core/logger.h"
+#include "core/nick_registry.h"
+#include "core/protocol.h"
+#include "core/room_history.h"
+#include "core/segment_store.h"
+#include "core/symbol_table.h"
 
 namespace core {
 
+// 동시성 구조
+// - 방(Room)이 독립적인 동시성 단위: 방마다 자기 mutex 로 멤버 목록/팬아웃을 보호
+//   -> 서로 다른 방의 chat/who 는 서로를 막지 않음
+// - 같은 방의 메시지는 방 락 안에서 enqueue 하므로 방 내부 순서가 보존됨
+// - 공유 상태는 세 군데뿐이고 각각 짧게만 잡음
+//     clients_mx_ : 연결 id -> Client 조회 (메시지 처리 시 shared 락)
+//     rooms_mx_   : 방 이름(id) -> Room 조회/생성/삭제
+//     nick_mx_    : 닉 등록 (hello / nick)
+//   (SymbolTable 의 락은 intern 할 때만, 다른 락을 잡지 않고 짧게)
+// - 락 순서: rooms_mx_ -> Room::mx (두 방은 std::scoped_lock 으로 동시에)
+//   nick_mx_, clients_mx_ 는 다른 락을 잡은 채로 얻지 않음
+//   (HistoryBudget 이 전역 예산을 되찾을 때 다른 방의 Room::mx 는 try_lock 만)
+// - 방마다 최근 chat 을 RoomHistory 에 보관: join/hello 때 replay, history 요청으로 페이지
+// - SegmentStore 가 있으면 chat 을 디스크에도 남김: 방을 처음 만들 때 seq/ring 을 복원하고
+//   ring 보다 오래된 페이지와 시간 기준(since) 조회는 store 에서 읽음
+//   (store 읽기는 방 락 밖에서: 반복되는 history 요청이 방의 팬아웃을 막지 않게)
+// - 압축(CompressOptions)은 hello 에서 협상한 TCP 연결에만: 프레임마다 한 번 압축해 공유
+//   room_dict 면 방의 chat 으로 사전을 한 번 만들어 방 멤버에게 알리고 이후 프레임에 씀
+// - 방/닉 이름은 SymbolTable 로 인터닝: 방 조회는 32비트 id 로, 문자열은 직렬화/로그에서만
+//   (Symbol::str() 을 view 로 넘기므로 팬아웃/로그 경로에서 이름 복사가 없음)
+// - Keepalive 가 있으면 연결마다 등록: 수신이 끊긴 연결은 ping 뒤 close (모든 transport 공통)
 class ChatCore {
 public:
-  explicit ChatCore(LogFn logger = nullptr);
+  explicit ChatCore(LogFn logger = nullptr, HistoryLimits history = {},
+                    std::shared_ptr<SegmentStore> store = nullptr,
+                    CompressOptions compress = {},
+                    std::shared_ptr<Keepalive> keepalive = nullptr);
+
+  const CompressStats& compress_stats() const { return z_.stats; }
 
   void on_connect(const ConnPtr& c);
   void on_disconnect(const ConnPtr& c);
   void on_message(const ConnPtr& c, const nlohmann::json& j);
+  // 프레임 payload 를 바로 처리: 평범한 메시지는 DOM 없이 디코딩하고 나머지는 DOM 으로
+  // 반환: false = 올바른 JSON 이 아님 (처리 방식은 트랜스포트가 정함)
+  bool on_frame(const ConnPtr& c, std::string_view payload);
 
 private:
+  struct Room;
+  using RoomPtr = std::shared_ptr<Room>;
+
+  // batch 하위 요청 하나의 결과 (첫 에러만)
+  struct ItemError {
+    bool failed = false;
+    std::string code, text;
+  };
+
+  // 한 연결의 on_message/on_disconnect 는 트랜스포트가 순차 호출하므로
+  // room/hello/nick_h 는 그 연결의 처리 스레드만 바꾼다.
+  // 다른 스레드가 읽는 nick 은 소속 방 락 안에서만 쓰고 읽는다.
   struct Client {
     ConnPtr conn;
-    std::string nick = "guest";
-    std::string room = "lobby";
+    Symbol nick; // on_connect 에서 guest
+    RoomPtr room;
     bool hello = false;
+    size_t room_slot = 0; // room->members 안에서의 위치
+    NickRegistry::Handle nick_h; // hello 이후 등록된 닉 (해제용)
+    bool batch_rx = false; // 여러 chat 을 batch 프레임 하나로 받음 (hello 에서, 방 락 안에서 쓰고 읽음)
+    ItemError* item_err = nullptr; // batch 처리 중이면 하위 요청의 에러를 여기로
   };
+  using ClientPtr = std::shared_ptr<Client>;
+
+  // 방 -> 멤버 인덱스 (fan-out/who 를 방 크기에 비례하게)
+  // Client* 는 on_disconnect 에서 방에서 빠진 뒤에야 해제됨
+  struct Room {
+    Room(Symbol n, const HistoryLimits& lim, HistoryBudget* budget)
+      : name(std::move(n)), history(lim, budget, &mx, name.id()) {}
+
+    Symbol name;
+    std::mutex mx;
+    std::vector<Client*> members;
+    uint64_t next_seq = 1; // 다음 chat 의 seq
+    RoomHistory history;
+    SegmentStore::RoomRef log; // store 가 있으면 restore_room 에서 한 번 엶 (이후 바뀌지 않음)
+    bool dead = false; // 비고 기록도 없어서 rooms_ 에서 빠짐 -> 새로 조회해야 함
+    zcodec::DictPtr dict;                 // 압축 사전 (room_dict, 학습이 끝난 뒤)
+    std::unique_ptr<DictTrainer> trainer; // 학습 중에만
+  };
+
+  // 방/클라이언트보다 먼저 선언 (그쪽이 쥔 Symbol 이 먼저 사라져야 함)
+  SymbolTable syms_;
+  Symbol lobby_, guest_; // 자주 쓰는 이름은 미리 인터닝 (복사는 참조 증가만)
 
-  mutable std::mutex mx_;
-  std::unordered_map<std::string, Client> clients_; // key = conn->id()
+  // 방들보다 먼저 선언: Room(RoomHistory) 소멸 시 전역 바이트를 반납함
+  HistoryLimits hist_;
+  HistoryBudget hist_budget_;
+
+  std::shared_mutex clients_mx_;
+  std::unordered_map<std::string, ClientPtr> clients_; // key = conn->id()
+  std::mutex rooms_mx_;
+  std::unordered_map<SymId, RoomPtr> rooms_;           // key = 방 이름 id
+  std::mutex nick_mx_;
+  NickRegistry nicks_;                                 // hello 한 클라이언트의 닉
   LogFn log_;
+  std::shared_ptr<SegmentStore> store_;
+  Compression z_; // 협상한 연결들이 가리킴 (연결보다 오래 삶)
+  std::shared_ptr<Keepalive> keepalive_;
+
+  void log_event(LogEvent ev, std::string_view room, std::string_view nick,
+                 std::string_view text);
 
-  void log_line(const std::string& s);
+  ClientPtr find_client(const std::string& id);
 
-  bool nick_taken_locked(const std::string& nick) const;
-  std::string make_unique_nick_locked(const std::string& base) const;
+  // 이름으로 방을 찾거나 만든다 (dead 여부는 방 락을 잡은 뒤 호출자가 확인)
+  // 새 방은 rooms_mx_ 밖에서 store 로부터 복원한 뒤 등록
+  RoomPtr get_room(const Symbol& name);
+  void restore_room(Room& r);
+  // 방이 비었고 기록도 없으면 rooms_ 에서 제거
+  void release_room(const RoomPtr& r);
+  // 전역 예산에 기록을 뺏겨 빈 방들 중 멤버도 없는 방을 제거 (get_room 에서)
+  void sweep_emptied_rooms();
 
-  void send_error(const ConnPtr& c, const std::string& req_id,
+  // 기존 닉을 반납하고 requested(또는 requested_N)를 새로 등록 (nick_mx_ 만 잡음)
+  Symbol register_nick(Client& cl, const std::string& requested);
+
+  void send_error(const ConnPtr& c, std::string_view req_id,
                   const std::string& code, const std::string& text);
+  // 핸들러용: batch 안이면 결과에 기록하고 아니면 error 를 보냄
+  void fail(Client& me, const ConnPtr& c, std::string_view req_id,
+            const std::string& code, const std::string& text);
+
+  // *_locked: 해당 Room::mx 를 잡은 상태에서 호출
+  static void room_add_locked(Room& r, Client& cl);
+  static void room_remove_locked(Room& r, Client& cl);
+
+  // subject: 이벤트 대상 닉 (로그 필터용, 텍스트 로그에는 찍히지 않음)
+  void send_system_to_room_locked(Room& r, std::string_view text,
+                                  std::string_view subject = {});
+  void broadcast_chat_to_room_locked(Room& r, const Symbol& from, std::string_view text);
+  // chat 하나를 seq/history/store/사전 학습에 반영하고 프레임을 돌려줌 (팬아웃은 호출자)
+  FramePtr append_chat_locked(Room& r, const Symbol& from, std::string_view text);
+  // 여러 chat 을 한 번에 팬아웃: batch_rx 멤버는 batch 프레임 하나로 (한 번만 만들어 공유)
+  void fanout_chats_locked(Room& r, const std::vector<FramePtr>& frames);
+  // frames 를 c 로 (batch 가 있으면 그것 하나로 대신). 실패하면 close 후 false
+  static bool send_frames(const ConnPtr& c, const std::vector<FramePtr>& frames,
+                          const FramePtr& batch);
+  void handle_who_locked(Room& r, const ConnPtr& c, std::string_view req_id);
+  // room_dict: chat 을 학습에 넣고, 사전이 완성되면 압축 연결들에게 알림
+  void train_dict_locked(Room& r, std::string_view payload);
+  // 압축 연결이면 방 사전을 보냄 (이 사전을 쓰는 프레임보다 먼저)
+  void send_dict_locked(Room& r, const ConnPtr& c);
+  // seq < before 인 chat 을 ring 에서 (최대 limit 개) 다시 보낸 뒤 history_ok
+  // explicit_req 가 아니면(입장 replay) 보낼 것이 없을 때 history_ok 도 생략
+  // batch_rx 면 chat 들을 batch 프레임 하나로
+  // 반환: false = explicit 요청인데 ring 이 모자라고 store 에 더 오래된 것이 있음
+  //       (아무것도 보내지 않음 -> 호출자가 락을 놓고 send_store_before)
+  bool send_history_locked(Room& r, const Client& to, std::string_view req_id,
+                           uint64_t before, size_t limit, bool explicit_req);
+  // store 에서 읽어 보낸 뒤 history_ok. 방 락 밖에서 호출 (dict 는 락 안에서 떠 둔 것)
+  // before: seq < before 인 것 중 최신 limit 개, since: ts >= since_us 인 것부터 limit 개
+  void send_store_before(const Room& r, const Client& to, std::string_view req_id,
+                         uint64_t before, size_t limit, const zcodec::DictPtr& dict);
+  void send_store_since(const Room& r, const Client& to, std::string_view req_id,
+                        int64_t since_us, size_t limit, const zcodec::DictPtr& dict);
+
+  void handle_join(Client& me, std::string_view new_room);
+
+  void dispatch(const ConnPtr& c, const proto::Request& m);
 
-  void drop_dead_clients_locked(); // optional; can be no-op
+  // 메시지 종류별 핸들러: proto::MsgType 로 인덱싱하는 테이블로 분기
+  // (종류가 늘어도 hot path 의 비교는 늘지 않음; 빈 칸 = unknown type)
+  using Handler = void (ChatCore::*)(Client& me, const ConnPtr& c, const proto::Request& m);
+  static const std::array<Handler, static_cast<size_t>(proto::MsgType::Count)> handlers_;
 
-  void send_system_to_room_locked(const std::string& room, const std::string& text);
-  void broadcast_chat_to_room_locked(const std::string& room,
-                                     const std::string& from,
-                                     const std::string& text);
-  void handle_who_locked(const ConnPtr& c, const std::string& req_id);
+  void on_hello(Client& me, const ConnPtr& c, const proto::Request& m);
+  void on_chat(Client& me, const ConnPtr& c, const proto::Request& m);
+  void on_join(Client& me, const ConnPtr& c, const proto::Request& m);
+  void on_nick(Client& me, const ConnPtr& c, const proto::Request& m);
+  void on_who(Client& me, const ConnPtr& c, const proto::Request& m);
+  void on_history(Client& me, const ConnPtr& c, const proto::Request& m);
+  // ping 에 대한 응답. 수신 시각은 dispatch 에서 이미 남겼으므로 할 일 없음
+  void on_pong(Client& me, const ConnPtr& c, const proto::Request& m);
+  // 하위 요청들을 순서대로 처리하고 batch_ok 로 결과를 한 번에
+  // 연속된 chat 은 방 락 한 번 안에서 처리하고 한 번에 팬아웃
+  void on_batch(Client& me, const ConnPtr& c, const proto::Request& m);
+  // items[i] 부터 이어지는 chat 들 (다음 chat 이 아닌 위치를 돌려줌)
+  size_t batch_chat_run(Client& me, const nlohmann::json& items, size_t i,
+                        nlohmann::json& results, size_t& failed);
 };
 
 } // namespace core
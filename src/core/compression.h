@@ -0,0 +1,80 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include "common/zcodec.h"
+
+namespace core {
+
+constexpr size_t kMaxDictBytes = 32 * 1024; // deflate window
+
+struct CompressOptions {
+  bool enabled = false;          // hello 에서 "compress":"deflate" 를 요청한 TCP 연결에만
+  size_t min_bytes = 512;        // 이보다 작은 payload 는 압축하지 않음
+  int level = 6;                 // zlib 1..9
+  bool room_dict = false;        // 방마다 최근 chat 으로 preset dictionary 를 만들어 씀
+  size_t dict_bytes = 16 * 1024; // 사전 크기 (최대 kMaxDictBytes)
+  size_t dict_train_bytes = 64 * 1024; // 이만큼 chat 을 본 뒤 사전을 만듦
+};
+
+// 압축 결과 (프레임당 한 번만 압축하므로 수신자 수와 무관)
+struct CompressStats {
+  std::atomic<uint64_t> frames{0};      // 압축해서 쓴 프레임
+  std::atomic<uint64_t> raw_bytes{0};   // 그 프레임들의 원래 payload
+  std::atomic<uint64_t> wire_bytes{0};  // 압축 후 payload
+  std::atomic<uint64_t> skipped{0};     // 압축해도 줄지 않아 원본을 씀
+  std::atomic<uint64_t> dicts{0};       // 만든 방 사전 수
+
+  // 압축 후 / 원래 (작을수록 좋음, 압축한 프레임이 없으면 1)
+  double ratio() const {
+    uint64_t raw = raw_bytes.load(std::memory_order_relaxed);
+    return raw ? static_cast<double>(wire_bytes.load(std::memory_order_relaxed)) / raw : 1.0;
+  }
+};
+
+// 서버 단위 압축 설정 + 카운터 (ChatCore 가 소유, 협상된 연결이 가리킴)
+struct Compression {
+  CompressOptions opt;
+  CompressStats stats;
+};
+
+// 방 사전 학습: 최근 chat payload 를 모아 두었다가 한 번 사전을 만듦
+// zlib 은 사전 끝쪽 문자열을 가장 가깝게 참조하므로 최근 것이 뒤에 오도록 이어 붙임
+// 스레드 안전하지 않음: 소유 방의 락 안에서 사용
+class DictTrainer {
+public:
+  explicit DictTrainer(const CompressOptions& opt) : opt_(opt) {}
+
+  void add(std::string_view payload) {
+    seen_ += payload.size();
+    const size_t cap = std::min(opt_.dict_bytes, kMaxDictBytes);
+    if (payload.size() > cap) return; // 통째로만 넣음 (사전이 UTF-8 중간에서 잘리지 않게)
+    samples_.emplace_back(payload);
+    kept_ += payload.size();
+    while (kept_ > cap) {
+      kept_ -= samples_.front().size();
+      samples_.pop_front();
+    }
+  }
+
+  bool ready() const { return seen_ >= opt_.dict_train_bytes; }
+
+  zcodec::DictPtr build() const {
+    std::string bytes;
+    bytes.reserve(kept_);
+    for (const auto& s : samples_) bytes += s;
+    return zcodec::Dict::make(std::move(bytes));
+  }
+
+private:
+  const CompressOptions& opt_;
+  std::deque<std::string> samples_;
+  size_t kept_ = 0;
+  size_t seen_ = 0;
+};
+
+} // namespace core
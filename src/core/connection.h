@@ -1,15 +1,71 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <nlohmann/json.hpp>
+#include "core/frame.h"
+#include "core/outbound_queue.h"
 
 namespace core {
 
+// 단조 시계 (ms). 수신 시각/keepalive 타이머가 같은 기준을 씀
+inline int64_t mono_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 struct Connection {
   virtual ~Connection() = default;
   virtual bool send(const nlohmann::json& j) = 0;
   virtual void close() = 0;
   virtual std::string id() const = 0; // unique key
+
+  // 논블로킹 송신: 미리 인코딩된 공유 프레임을 연결별 bounded 큐에 넣고
+  // 실제 전송은 I/O 계층이 담당 (블로킹 transport 는 바로 씀)
+  // false = 연결이 죽었거나 느린 소비자 정책상 끊어야 함
+  virtual bool enqueue(const FramePtr& f, MsgClass cls) = 0;
+
+  // 단일 수신자용 편의 함수 (이 연결의 인코딩으로 바로 직렬화)
+  bool enqueue(const nlohmann::json& j, MsgClass cls) {
+    return enqueue(Frame::from_json(j, encoding()), cls);
+  }
+
+  // 송신 인코딩 (hello 에서 협상, 기본 JSON)
+  // transport 의 enqueue 는 Frame::as(f, encoding()) 로 맞춘 프레임을 보냄
+  Encoding encoding() const { return enc_.load(std::memory_order_relaxed); }
+  void set_encoding(Encoding e) { enc_.store(e, std::memory_order_relaxed); }
+
+  // 길이 헤더 압축 플래그를 보낼 수 있는 transport 인지 (TCP 계열만 true)
+  virtual bool can_compress() const { return false; }
+
+  // hello 에서 압축을 협상했으면 서버의 Compression, 아니면 nullptr
+  // transport 의 enqueue 는 Frame::compressed(f, *compression()) 로 압축본을 보냄
+  Compression* compression() const { return z_.load(std::memory_order_acquire); }
+  void set_compression(Compression* z) { z_.store(z, std::memory_order_release); }
+
+  // hello 에서 batch 수신을 요청한 연결이면 true
+  // transport 는 큐에 이어서 쌓인 chat 프레임들을 Frame::batch 하나로 합쳐 보내도 됨
+  bool batch_rx() const { return batch_rx_.load(std::memory_order_relaxed); }
+  void set_batch_rx(bool b) { batch_rx_.store(b, std::memory_order_relaxed); }
+
+  // 마지막으로 뭔가 받은 시각 (core 가 메시지마다, WS 는 컨트롤 프레임에서도 갱신)
+  // Keepalive 가 읽어서 ping/close 여부를 정함
+  void mark_rx(int64_t now_ms = mono_ms()) { last_rx_.store(now_ms, std::memory_order_relaxed); }
+  int64_t last_rx_ms() const { return last_rx_.load(std::memory_order_relaxed); }
+
+  // 살아 있는지 확인 요청 (Keepalive 스레드에서 호출). 기본은 프로토콜 ping 메시지
+  // 클라이언트가 pong 을 보내면 그 수신이 곧 응답. WS 는 ping 컨트롤 프레임으로 대신함
+  virtual void ping() {
+    if (!enqueue(nlohmann::json{{"v",1},{"type","ping"}}, MsgClass::System)) close();
+  }
+
+private:
+  std::atomic<Encoding> enc_{Encoding::Json};
+  std::atomic<int64_t> last_rx_{0};
+  std::atomic<bool> batch_rx_{false};
+  std::atomic<Compression*> z_{nullptr};
 };
 
 using ConnPtr = std::shared_ptr<Connection>;
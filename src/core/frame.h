@@ -0,0 +1,138 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "common/frame_decoder.h"
+#include "common/zcodec.h"
+#include "core/compression.h"
+#include "net/net_platform.h"
+
+namespace core {
+
+// 프레임 payload 인코딩 (연결마다 hello 에서 협상)
+// - Json   : 프로토콜 v1, 텍스트
+// - MsgPack: 프로토콜 v2, 같은 구조를 MessagePack 으로 (WS 는 binary 프레임)
+enum class Encoding : uint8_t { Json, MsgPack };
+
+inline const char* encoding_name(Encoding e) {
+  return e == Encoding::MsgPack ? "msgpack" : "json";
+}
+
+class Frame;
+using FramePtr = std::shared_ptr<const Frame>;
+
+// 한 번만 직렬화해서 모든 수신자가 공유하는 불변 프레임
+// - 버퍼 하나에 [4바이트 BE 길이][payload] 를 담아 두 wire 포맷을 모두 커버
+//   TCP: tcp_bytes() (길이 프레이밍 포함), WS: text() (텍스트/바이너리 프레임 payload)
+// - 다른 인코딩이 필요한 수신자가 있으면 as() 가 한 번만 변환해 프레임에 붙여 둠
+//   -> 브로드캐스트 하나당 "쓰이는 인코딩 수" 만큼만 인코딩
+// - 압축도 같은 방식: compressed() 가 처음 한 번만 deflate 해서 붙여 두고 수신자끼리 공유
+//   dict 는 프레임이 속한 방의 preset dictionary (없으면 nullptr)
+class Frame {
+public:
+  explicit Frame(std::string_view payload, Encoding enc = Encoding::Json,
+                 zcodec::DictPtr dict = nullptr, bool compressed = false)
+    : enc_(enc), compressed_(compressed), dict_(std::move(dict)) {
+    buf_.resize(sizeof(uint32_t) + payload.size());
+    uint32_t len = static_cast<uint32_t>(payload.size());
+    uint32_t be_len = htonl(compressed ? (len | framing::kFrameCompressed) : len);
+    std::memcpy(&buf_[0], &be_len, sizeof(be_len));
+    if (!payload.empty()) std::memcpy(&buf_[sizeof(uint32_t)], payload.data(), payload.size());
+  }
+
+  static FramePtr from_json(const nlohmann::json& j, Encoding enc = Encoding::Json,
+                            zcodec::DictPtr dict = nullptr) {
+    if (enc == Encoding::MsgPack) {
+      std::vector<uint8_t> b = nlohmann::json::to_msgpack(j);
+      return std::make_shared<const Frame>(
+        std::string_view(reinterpret_cast<const char*>(b.data()), b.size()), enc, std::move(dict));
+    }
+    return std::make_shared<const Frame>(j.dump(), enc, std::move(dict));
+  }
+
+  // f 를 enc 로 (같으면 그대로, 다르면 처음 요청한 스레드가 변환해 캐시)
+  static FramePtr as(const FramePtr& f, Encoding enc) {
+    if (!f || f->enc_ == enc || f->compressed_) return f;
+    std::call_once(f->alt_once_, [&] {
+      try {
+        nlohmann::json j = f->enc_ == Encoding::MsgPack
+          ? nlohmann::json::from_msgpack(f->text())
+          : nlohmann::json::parse(f->text());
+        f->alt_ = from_json(j, enc, f->dict_);
+      } catch (...) {
+        // 변환 불가 (직접 만든 프레임) -> 원본 그대로
+      }
+    });
+    return f->alt_ ? f->alt_ : f;
+  }
+
+  // f 의 압축본 (작거나 줄지 않으면 f 그대로). 처음 요청한 스레드가 압축해 캐시
+  static FramePtr compressed(const FramePtr& f, Compression& z) {
+    if (!f || f->compressed_ || f->payload_size() < z.opt.min_bytes) return f;
+    std::call_once(f->z_once_, [&] {
+      std::string out;
+      if (zcodec::deflate(f->text(), f->dict_.get(), z.opt.level, out) &&
+          out.size() < f->payload_size()) {
+        z.stats.frames.fetch_add(1, std::memory_order_relaxed);
+        z.stats.raw_bytes.fetch_add(f->payload_size(), std::memory_order_relaxed);
+        z.stats.wire_bytes.fetch_add(out.size(), std::memory_order_relaxed);
+        f->z_ = std::make_shared<const Frame>(out, f->enc_, nullptr, true);
+      } else {
+        z.stats.skipped.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+    return f->z_ ? f->z_ : f;
+  }
+
+  // JSON 프레임 여러 개를 {"items":[...],"type":"batch","v":1} 하나로 (재직렬화 없이 이어 붙임)
+  // 키 순서는 nlohmann dump 와 같게
+  // 2개 미만, JSON 아닌 프레임, 최대 프레임 크기 초과면 nullptr
+  static FramePtr batch(const std::vector<FramePtr>& frames, zcodec::DictPtr dict = nullptr) {
+    if (frames.size() < 2) return nullptr;
+    static constexpr std::string_view head = R"({"items":[)";
+    static constexpr std::string_view tail = R"(],"type":"batch","v":1})";
+    size_t n = head.size() + tail.size() + frames.size();
+    for (const FramePtr& f : frames) {
+      if (f->enc_ != Encoding::Json || f->compressed_) return nullptr;
+      n += f->payload_size();
+    }
+    if (n > framing::kMaxFrameSize) return nullptr;
+
+    std::string p;
+    p.reserve(n);
+    p += head;
+    for (size_t i = 0; i < frames.size(); i++) {
+      if (i) p += ',';
+      p += frames[i]->text();
+    }
+    p += tail;
+    auto b = std::make_shared<Frame>(p, Encoding::Json, std::move(dict));
+    b->batch_ = true;
+    return b;
+  }
+
+  Encoding encoding() const { return enc_; }
+  bool is_compressed() const { return compressed_; }
+  bool is_batch() const { return batch_; }
+  std::string_view tcp_bytes() const { return buf_; }
+  std::string_view text() const { return std::string_view(buf_).substr(sizeof(uint32_t)); }
+  size_t payload_size() const { return buf_.size() - sizeof(uint32_t); }
+
+private:
+  std::string buf_;
+  Encoding enc_;
+  bool compressed_;
+  bool batch_ = false;
+  zcodec::DictPtr dict_;
+  mutable std::once_flag alt_once_;
+  mutable FramePtr alt_; // 다른 인코딩 (인코딩이 둘뿐이라 하나면 충분)
+  mutable std::once_flag z_once_;
+  mutable FramePtr z_;   // 압축본
+};
+
+} // namespace core
@@ -0,0 +1,93 @@
+#include "core/keepalive.h"
+
+#include <vector>
+
+namespace core {
+
+Keepalive::Keepalive(KeepaliveOptions opt)
+  : opt_(opt), wheel_(mono_ms() / (opt.tick_ms ? opt.tick_ms : 1)) {
+  if (!opt_.tick_ms) opt_.tick_ms = 1;
+  th_ = std::thread([this] { run(); });
+}
+
+Keepalive::~Keepalive() { stop(); }
+
+void Keepalive::stop() {
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (th_.joinable()) th_.join();
+}
+
+void Keepalive::add(const ConnPtr& c) {
+  if (!c) return;
+  int64_t now = mono_ms();
+  c->mark_rx(now);
+  std::lock_guard<std::mutex> lk(mx_);
+  auto& e = entries_[c.get()];
+  if (!e) e = std::make_unique<Entry>();
+  e->key = c.get();
+  e->conn = c;
+  e->ping_ms = 0;
+  wheel_.schedule(e.get(), tick_at(now + opt_.idle_ms));
+}
+
+void Keepalive::remove(const Connection* c) {
+  std::lock_guard<std::mutex> lk(mx_);
+  auto it = entries_.find(c);
+  if (it == entries_.end()) return;
+  wheel_.cancel(it->second.get());
+  entries_.erase(it);
+}
+
+size_t Keepalive::tracked() const {
+  std::lock_guard<std::mutex> lk(mx_);
+  return entries_.size();
+}
+
+void Keepalive::run() {
+  // ping/close 는 락 밖에서 (close 가 on_disconnect -> remove 로 다시 들어올 수 있음)
+  std::vector<ConnPtr> to_ping, to_close;
+  std::unique_lock<std::mutex> lk(mx_);
+  while (!stop_) {
+    cv_.wait_for(lk, std::chrono::milliseconds(opt_.tick_ms), [this] { return stop_; });
+    if (stop_) break;
+
+    int64_t now = mono_ms();
+    wheel_.advance(static_cast<uint64_t>(now) / opt_.tick_ms, [&](TimerWheel::Timer* t) {
+      Entry* e = static_cast<Entry*>(t);
+      ConnPtr c = e->conn.lock();
+      if (!c) {
+        entries_.erase(e->key);
+        return;
+      }
+      int64_t rx = c->last_rx_ms();
+      if (e->ping_ms && rx < e->ping_ms) {
+        to_close.push_back(std::move(c)); // 타이머는 다시 걸지 않음 (remove 를 기다림)
+        return;
+      }
+      if (now - rx < static_cast<int64_t>(opt_.idle_ms)) {
+        e->ping_ms = 0;
+        wheel_.schedule(e, tick_at(rx + opt_.idle_ms));
+        return;
+      }
+      e->ping_ms = now;
+      wheel_.schedule(e, tick_at(now + opt_.timeout_ms));
+      to_ping.push_back(std::move(c));
+    });
+    if (to_ping.empty() && to_close.empty()) continue;
+
+    lk.unlock();
+    for (auto& c : to_ping) c->ping();
+    for (auto& c : to_close) c->close();
+    stats_.pings.fetch_add(to_ping.size(), std::memory_order_relaxed);
+    stats_.evicted.fetch_add(to_close.size(), std::memory_order_relaxed);
+    to_ping.clear();
+    to_close.clear();
+    lk.lock();
+  }
+}
+
+} // namespace core
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "core/connection.h"
+#include "core/timer_wheel.h"
+
+namespace core {
+
+struct KeepaliveOptions {
+  uint32_t idle_ms = 30000;    // 이만큼 아무것도 받지 못하면 ping
+  uint32_t timeout_ms = 10000; // ping 뒤 이만큼 더 조용하면 끊음
+  uint32_t tick_ms = 100;      // 타이머 해상도
+};
+
+struct KeepaliveStats {
+  std::atomic<uint64_t> pings{0};
+  std::atomic<uint64_t> evicted{0};
+};
+
+// 반쯤 열린(half-open) 연결 정리: 수신이 끊긴 연결에 ping 을 보내고, 답이 없으면 close
+// - 연결마다 타이머 하나를 TimerWheel 에 걸고 스레드 하나가 tick 마다 휠을 돌림
+// - 수신할 때마다 타이머를 옮기지 않음: Connection::mark_rx() 가 시각만 남기고
+//   만료 때 그 시각을 보고 다시 걸거나(살아 있음) ping/close 로 넘어감
+// - ping 방식은 transport 가 정함 (Connection::ping: TCP 는 프로토콜 ping, WS 는 ping 프레임)
+// - close 뒤의 정리는 평소처럼 transport -> ChatCore::on_disconnect -> remove
+class Keepalive {
+public:
+  explicit Keepalive(KeepaliveOptions opt = {});
+  ~Keepalive();
+  Keepalive(const Keepalive&) = delete;
+  Keepalive& operator=(const Keepalive&) = delete;
+
+  void add(const ConnPtr& c);
+  void remove(const Connection* c);
+  void stop();
+
+  const KeepaliveOptions& options() const { return opt_; }
+  const KeepaliveStats& stats() const { return stats_; }
+  size_t tracked() const;
+
+private:
+  struct Entry : TimerWheel::Timer {
+    const Connection* key = nullptr;
+    std::weak_ptr<Connection> conn;
+    int64_t ping_ms = 0; // 보낸 ping 의 시각 (0 = 응답 대기 중 아님)
+  };
+
+  uint64_t tick_at(int64_t ms) const { return (static_cast<uint64_t>(ms) + opt_.tick_ms - 1) / opt_.tick_ms; }
+  void run();
+
+  KeepaliveOptions opt_;
+  KeepaliveStats stats_;
+
+  mutable std::mutex mx_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  TimerWheel wheel_;
+  std::unordered_map<const Connection*, std::unique_ptr<Entry>> entries_;
+  std::thread th_;
+};
+
+} // namespace core
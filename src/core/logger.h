@@ -1,7 +1,54 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <functional>
 
 namespace core {
-using LogFn = std::function<void(const std::string&)>;
+
+// ChatCore 가 남기는 로그 이벤트 (값은 바이너리 로그의 레코드 종류와 같음)
+enum class LogEvent : uint8_t { Connect = 1, Disconnect = 2, System = 3, Chat = 4 };
+
+// 구조화된 로그 레코드 (호출 동안만 유효한 view)
+// - Connect/Disconnect: text = 연결 id
+// - System: room, text (nick = 대상 닉이 있으면; 텍스트 로그에는 찍지 않음)
+// - Chat  : room, nick, text
+struct LogRecord {
+  LogEvent ev = LogEvent::System;
+  std::string_view room;
+  std::string_view nick;
+  std::string_view text;
+};
+
+using LogFn = std::function<void(const LogRecord&)>;
+
+inline const char* log_event_name(LogEvent ev) {
+  switch (ev) {
+    case LogEvent::Connect: return "connect";
+    case LogEvent::Disconnect: return "disconnect";
+    case LogEvent::System: return "system";
+    case LogEvent::Chat: return "chat";
+  }
+  return "?";
+}
+
+// 텍스트 로그 한 줄: "[chat][room][nick] text", "[system][room] text", "[connect] id"
+inline void append_log_line(std::string& out, const LogRecord& r) {
+  out += '[';
+  out += log_event_name(r.ev);
+  out += ']';
+  if (r.ev == LogEvent::System || r.ev == LogEvent::Chat) {
+    out += '[';
+    out.append(r.room);
+    out += ']';
+  }
+  if (r.ev == LogEvent::Chat) {
+    out += '[';
+    out.append(r.nick);
+    out += ']';
+  }
+  out += ' ';
+  out.append(r.text);
+}
+
 } // namespace core
@@ -0,0 +1,54 @@
+#include "core/nick_registry.h"
+#include <algorithm>
+#include <functional>
+
+namespace core {
+
+NickRegistry::Handle NickRegistry::acquire(const std::string& base) {
+  Handle h;
+  h.base = base;
+  if (taken_.insert(base).second) {
+    h.nick = base;
+    return h;
+  }
+
+  SuffixState& st = suffix_[base];
+  for (;;) {
+    int n = 0;
+    if (!st.freed.empty()) {
+      std::pop_heap(st.freed.begin(), st.freed.end(), std::greater<int>());
+      n = st.freed.back();
+      st.freed.pop_back();
+    } else {
+      n = st.next++;
+    }
+    // 누군가 "base_N" 을 직접 요청해 쓰고 있을 수 있으므로 확인 (드묾)
+    std::string cand = base + "_" + std::to_string(n);
+    if (taken_.insert(cand).second) {
+      st.live++;
+      h.nick = std::move(cand);
+      h.suffix = n;
+      return h;
+    }
+  }
+}
+
+void NickRegistry::release(const Handle& h) {
+  if (h.nick.empty() || taken_.erase(h.nick) == 0) return;
+  if (h.suffix == 0) return;
+
+  auto it = suffix_.find(h.base);
+  if (it == suffix_.end()) return;
+  SuffixState& st = it->second;
+  if (st.live > 0) st.live--;
+
+  if (st.live == 0) {
+    // 이 base 의 suffix 사용자가 모두 떠남 -> 상태 초기화 (메모리 회수)
+    suffix_.erase(it);
+    return;
+  }
+  st.freed.push_back(h.suffix);
+  std::push_heap(st.freed.begin(), st.freed.end(), std::greater<int>());
+}
+
+} // namespace core
@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace core {
+
+// 닉네임 등록부 (해시 기반, 할당/해제 O(1) 평균)
+// - base 가 비어 있으면 base 그대로, 아니면 base_N 을 할당
+// - base 별로 다음 suffix 와 반납된 suffix(작은 번호 우선 재사용)를 추적하므로
+//   guest_N 이 수천 명이어도 전체 스캔 없이 결정적으로 할당됨
+// - 스레드 안전하지 않음: 호출자 락 안에서 사용
+class NickRegistry {
+public:
+  struct Handle {
+    std::string nick;
+    std::string base;
+    int suffix = 0; // 0 = suffix 없이 base 그대로
+  };
+
+  Handle acquire(const std::string& base);
+  void release(const Handle& h);
+  bool taken(const std::string& nick) const { return taken_.count(nick) != 0; }
+  size_t size() const { return taken_.size(); }
+
+private:
+  struct SuffixState {
+    int next = 2;
+    std::vector<int> freed; // min-heap
+    size_t live = 0;        // 현재 사용 중인 base_N 개수
+  };
+
+  std::unordered_set<std::string> taken_;
+  std::unordered_map<std::string, SuffixState> suffix_;
+};
+
+} // namespace core
@@ -0,0 +1,96 @@
+#include "core/outbound_queue.h"
+
+namespace core {
+
+bool OutboundQueue::fits_(size_t add) const {
+  return bytes_ + add <= limits_->max_bytes && q_.size() + 1 <= limits_->max_msgs;
+}
+
+bool OutboundQueue::evict_one_(bool chat_only) {
+  // 부분 전송 중인 맨 앞 프레임은 건드리지 않음 (스트림이 깨짐)
+  auto it = q_.begin();
+  if (it != q_.end() && head_off_ > 0) ++it;
+  for (; it != q_.end(); ++it) {
+    if (chat_only && it->cls != MsgClass::Chat) continue;
+    bytes_ -= it->wire_size();
+    q_.erase(it);
+    return true;
+  }
+  return false;
+}
+
+OutboundQueue::Push OutboundQueue::push(FramePtr frame, MsgClass cls) {
+  Item f{std::move(frame), cls};
+  size_t add = f.wire_size();
+
+  if (!fits_(add)) {
+    switch (limits_->policy) {
+      case SlowConsumerPolicy::Disconnect:
+        stats_->disconnected++;
+        return Push::Overflow;
+
+      case SlowConsumerPolicy::DropChat:
+        if (cls == MsgClass::Chat) {
+          stats_->dropped_chat++;
+          return Push::Dropped;
+        }
+        while (!fits_(add) && evict_one_(true)) stats_->dropped_chat++;
+        if (!fits_(add)) {
+          stats_->disconnected++;
+          return Push::Overflow;
+        }
+        break;
+
+      case SlowConsumerPolicy::DropOldest:
+        while (!fits_(add) && evict_one_(false)) stats_->dropped_oldest++;
+        if (!fits_(add)) {
+          stats_->dropped_new++;
+          return Push::Dropped;
+        }
+        break;
+    }
+  }
+
+  bytes_ += add;
+  q_.push_back(std::move(f));
+  stats_->queued++;
+  uint64_t peak = stats_->peak_bytes.load(std::memory_order_relaxed);
+  while (bytes_ > peak &&
+         !stats_->peak_bytes.compare_exchange_weak(peak, bytes_, std::memory_order_relaxed)) {
+  }
+  return Push::Queued;
+}
+
+void OutboundQueue::consume(size_t n) {
+  bytes_ -= n;
+  while (n > 0 && !q_.empty()) {
+    size_t left = q_.front().wire_size() - head_off_;
+    if (n < left) {
+      head_off_ += n;
+      return;
+    }
+    n -= left;
+    q_.pop_front();
+    head_off_ = 0;
+  }
+}
+
+size_t OutboundQueue::take(std::deque<Item>& out, size_t max) {
+  if (head_off_ > 0) return 0;
+  size_t n = 0;
+  while (n < max && !q_.empty()) {
+    bytes_ -= q_.front().wire_size();
+    out.push_back(std::move(q_.front()));
+    q_.pop_front();
+    n++;
+  }
+  return n;
+}
+
+void OutboundQueue::clear() {
+  q_.clear();
+  bytes_ = 0;
+  head_off_ = 0;
+}
+
+} // namespace core
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include "core/frame.h"
+
+namespace core {
+
+// 송신 메시지 분류 (느린 소비자 정책에서 무엇을 버릴지 결정)
+enum class MsgClass { Chat, System };
+
+// 큐가 high-water mark 를 넘었을 때의 처리
+// - DropOldest: 오래된 프레임부터 버림
+// - DropChat  : chat 은 버리고 system/응답은 유지 (system 도 못 넣으면 연결 종료)
+// - Disconnect: 연결 종료
+enum class SlowConsumerPolicy { DropOldest, DropChat, Disconnect };
+
+struct OutboundLimits {
+  SlowConsumerPolicy policy = SlowConsumerPolicy::Disconnect;
+  size_t max_bytes = 4 * 1024 * 1024; // 연결당 대기 바이트 상한
+  size_t max_msgs = 8192;             // 연결당 대기 프레임 상한
+};
+
+// 결과별 카운터 (서버 단위로 공유)
+struct OutboundStats {
+  std::atomic<uint64_t> queued{0};
+  std::atomic<uint64_t> dropped_oldest{0};
+  std::atomic<uint64_t> dropped_chat{0};
+  std::atomic<uint64_t> dropped_new{0};    // 단일 프레임이 상한보다 커서 버림
+  std::atomic<uint64_t> disconnected{0};
+  std::atomic<uint64_t> coalesced{0};      // batch 프레임 하나로 합쳐 보낸 chat 수
+  std::atomic<uint64_t> peak_bytes{0};     // 연결 하나의 대기 바이트 최댓값 (큐 깊이)
+};
+
+// 연결당 bounded 송신 큐 (길이 프레이밍 단위)
+// - 스레드 안전하지 않음: 소유 transport 의 락 안에서 사용
+// - 맨 앞 프레임이 일부 전송된 상태(head_off > 0)면 그 프레임은 버리지 않음
+class OutboundQueue {
+public:
+  struct Item {
+    FramePtr frame;       // 여러 연결이 공유하는 인코딩 결과
+    MsgClass cls;
+    size_t wire_size() const { return frame->tcp_bytes().size(); }
+  };
+
+  enum class Push { Queued, Dropped, Overflow };
+
+  OutboundQueue(const OutboundLimits* limits, OutboundStats* stats)
+    : limits_(limits), stats_(stats) {}
+
+  // Overflow 면 정책상 연결을 끊어야 함
+  Push push(FramePtr frame, MsgClass cls);
+
+  std::deque<Item>& items() { return q_; }
+  bool empty() const { return q_.empty(); }
+  size_t bytes() const { return bytes_; }
+
+  // 전송된 바이트만큼 앞에서부터 소비
+  void consume(size_t n);
+
+  // 앞에서부터 최대 max 개 프레임을 통째로 꺼냄 (부분 전송 상태가 아닐 때만)
+  // 꺼낸 프레임은 더 이상 큐 상한/정책 대상이 아님 (이미 커널에 넘긴 것으로 취급)
+  size_t take(std::deque<Item>& out, size_t max);
+  void clear();
+
+  size_t head_off() const { return head_off_; }
+
+private:
+  bool fits_(size_t add) const;
+  bool evict_one_(bool chat_only);
+
+  const OutboundLimits* limits_;
+  OutboundStats* stats_;
+  std::deque<Item> q_;
+  size_t bytes_ = 0;    // 아직 안 보낸 바이트
+  size_t head_off_ = 0; // 맨 앞 프레임에서 이미 보낸 바이트
+};
+
+} // namespace core
@@ -1,5 +1,10 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <nlohmann/json.hpp>
 
 namespace core::proto {
@@ -19,7 +24,132 @@ inline std::string req_id(const nlohmann::json& j) {
   return "";
 }
 
-inline nlohmann::json make_error(const std::string& req_id,
+// 클라이언트 -> 서버 메시지 종류 (ChatCore 의 핸들러 테이블 인덱스)
+enum class MsgType : uint8_t { Unknown = 0, Hello, Chat, Join, Nick, Who, History, Batch, Pong, Count };
+
+inline constexpr std::string_view kMsgTypeNames[] = {
+  "", "hello", "chat", "join", "nick", "who", "history", "batch", "pong",
+};
+static_assert(std::size(kMsgTypeNames) == static_cast<size_t>(MsgType::Count));
+
+// 완전 해시: (길이, 첫 글자, 끝 글자) -> 16 슬롯
+// 후보가 슬롯당 하나라 조회는 해시 + 문자열 비교 1회. 새 종류가 충돌하면 static_assert 가 막음
+inline constexpr size_t kMsgTypeSlots = 16;
+
+constexpr size_t msg_type_hash(std::string_view s) {
+  if (s.empty()) return 0;
+  return (s.size() + static_cast<unsigned char>(s.front()) +
+          static_cast<unsigned char>(s.back()) * 5) & (kMsgTypeSlots - 1);
+}
+
+struct MsgTypeTable {
+  MsgType slot[kMsgTypeSlots] = {};
+  bool perfect = true;
+};
+
+constexpr MsgTypeTable make_msg_type_table() {
+  MsgTypeTable t;
+  for (size_t i = 1; i < static_cast<size_t>(MsgType::Count); i++) {
+    MsgType& s = t.slot[msg_type_hash(kMsgTypeNames[i])];
+    if (s != MsgType::Unknown) t.perfect = false;
+    s = static_cast<MsgType>(i);
+  }
+  return t;
+}
+
+inline constexpr MsgTypeTable kMsgTypeTable = make_msg_type_table();
+static_assert(kMsgTypeTable.perfect, "msg_type_hash collision: adjust the hash");
+
+constexpr MsgType msg_type(std::string_view s) {
+  const MsgType t = kMsgTypeTable.slot[msg_type_hash(s)];
+  return kMsgTypeNames[static_cast<size_t>(t)] == s ? t : MsgType::Unknown;
+}
+
+// 부호 없는 정수 필드 (present 인데 ok 가 아니면 타입 오류)
+struct UintField {
+  bool present = false;
+  bool ok = false;
+  uint64_t value = 0;
+};
+
+// 수신 메시지에서 ChatCore 가 쓰는 필드를 객체를 한 번 훑어 뽑은 것
+// - string_view 는 원본 json 이 살아 있는 동안만 유효
+// - 문자열 필드는 문자열로 들어왔을 때만 값이 있음
+struct Request {
+  MsgType type = MsgType::Unknown;
+  std::string_view type_name; // 문자열 type 원문 (없거나 문자열이 아니면 빈 값)
+  std::string_view req_id;
+  int v = 1;
+  std::optional<std::string_view> nick, text, room;
+  std::optional<std::string_view> enc; // hello (v2): 원하는 인코딩 "json" | "msgpack"
+  std::optional<std::string_view> compress; // hello: 서버->클라 프레임 압축 "deflate" (TCP)
+  std::optional<bool> batch; // hello: 여러 chat 을 batch 프레임 하나로 받아도 됨
+  UintField before, limit, since;
+  const nlohmann::json* items = nullptr; // batch: 하위 요청 배열 (DOM 경로에서만)
+};
+
+// batch 하나에 담을 수 있는 하위 요청 수
+inline constexpr size_t kMaxBatchItems = 512;
+
+inline Request parse_request(const nlohmann::json& j) {
+  Request r;
+  if (!j.is_object()) return r;
+
+  auto str = [](const nlohmann::json& x) -> std::optional<std::string_view> {
+    if (!x.is_string()) return std::nullopt;
+    return std::string_view(x.get_ref<const std::string&>());
+  };
+  auto uint = [](const nlohmann::json& x) {
+    UintField f;
+    f.present = true;
+    if (x.is_number_unsigned()) {
+      f.ok = true;
+      f.value = x.get<uint64_t>();
+    }
+    return f;
+  };
+
+  for (auto it = j.begin(); it != j.end(); ++it) {
+    const std::string& k = it.key();
+    const nlohmann::json& x = it.value();
+    // 키 길이로 먼저 나눠 비교 횟수를 줄임
+    switch (k.size()) {
+      case 1:
+        if (k == "v" && x.is_number_integer()) r.v = x.get<int>();
+        break;
+      case 3:
+        if (k == "enc") r.enc = str(x);
+        break;
+      case 4:
+        if (k == "type") {
+          r.type_name = str(x).value_or(std::string_view{});
+          r.type = msg_type(r.type_name);
+        } else if (k == "nick") r.nick = str(x);
+        else if (k == "text") r.text = str(x);
+        else if (k == "room") r.room = str(x);
+        break;
+      case 5:
+        if (k == "limit") r.limit = uint(x);
+        else if (k == "since") r.since = uint(x);
+        else if (k == "batch" && x.is_boolean()) r.batch = x.get<bool>();
+        else if (k == "items") r.items = &x;
+        break;
+      case 6:
+        if (k == "req_id") {
+          r.req_id = str(x).value_or(std::string_view{});
+        } else if (k == "before") r.before = uint(x);
+        break;
+      case 8:
+        if (k == "compress") r.compress = str(x);
+        break;
+      default:
+        break;
+    }
+  }
+  return r;
+}
+
+inline nlohmann::json make_error(std::string_view req_id,
                                  const std::string& code,
                                  const std::string& text) {
   nlohmann::json e = {{"v",1},{"type","error"},{"code",code},{"text",text}};
@@ -27,28 +157,70 @@ inline nlohmann::json make_error(const std::string& req_id,
   return e;
 }
 
-inline nlohmann::json make_system(const std::string& text) {
+inline nlohmann::json make_system(std::string_view text) {
   return {{"v",1},{"type","system"},{"text",text}};
 }
 
-inline nlohmann::json make_chat(const std::string& room,
-                                const std::string& from,
-                                const std::string& text) {
-  return {{"v",1},{"type","chat"},{"room",room},{"from",from},{"text",text}};
+// seq: 방 안에서 증가하는 메시지 번호 (history 의 before 커서로 사용)
+inline nlohmann::json make_chat(std::string_view room,
+                                std::string_view from,
+                                std::string_view text,
+                                uint64_t seq = 0) {
+  nlohmann::json c = {{"v",1},{"type","chat"},{"room",room},{"from",from},{"text",text}};
+  if (seq) c["seq"] = seq;
+  return c;
+}
+
+// 방 압축 사전: 이후 이 방의 압축 프레임은 zlib DICTID == id 로 이 사전을 참조
+// data = 사전 바이트 (JSON 텍스트 조각이라 문자열로 실어 보냄)
+inline nlohmann::json make_dict(std::string_view room, uint32_t id, const std::string& data) {
+  return {{"v",1},{"type","dict"},{"room",room},{"id",id},{"data",data}};
+}
+
+// batch 응답: 하위 요청마다의 결과 중 req_id 가 있거나 실패한 것만
+// (i = batch 안에서의 위치, ok = false 면 code/text)
+inline nlohmann::json make_batch_ok(std::string_view req_id, size_t count, size_t failed,
+                                    nlohmann::json results) {
+  nlohmann::json r = {{"v",1},{"type","batch_ok"},{"count",count},{"failed",failed},
+                      {"results",std::move(results)}};
+  if (!req_id.empty()) r["req_id"] = req_id;
+  return r;
 }
 
-inline nlohmann::json make_who_ok(const std::string& req_id,
-                                  const std::string& room,
+inline nlohmann::json make_who_ok(std::string_view req_id,
+                                  std::string_view room,
                                   const nlohmann::json& users) {
   nlohmann::json r = {{"v",1},{"type","who_ok"},{"room",room},{"users",users}};
   if (!req_id.empty()) r["req_id"] = req_id;
   return r;
 }
 
-inline nlohmann::json make_hello_ok(const std::string& req_id,
-                                    const std::string& nick,
-                                    const std::string& room) {
+// enc: v2 hello 에 대한 응답이면 확정된 인코딩 (이후 프레임부터 적용). v1 이면 비움
+// compress: 압축을 수락했으면 "deflate" (이후 프레임부터 압축 플래그가 붙을 수 있음)
+inline nlohmann::json make_hello_ok(std::string_view req_id,
+                                    std::string_view nick,
+                                    std::string_view room,
+                                    std::string_view enc = {},
+                                    std::string_view compress = {}) {
   nlohmann::json r = {{"v",1},{"type","hello_ok"},{"nick",nick},{"room",room}};
+  if (!enc.empty()) {
+    r["v"] = 2;
+    r["enc"] = enc;
+  }
+  if (!compress.empty()) r["compress"] = compress;
+  if (!req_id.empty()) r["req_id"] = req_id;
+  return r;
+}
+
+// history 응답: 직전에 보낸 chat count 개의 요약
+// before = 보낸 것 중 가장 오래된 seq (다음 페이지 요청의 커서), more = 더 오래된 것이 남음
+inline nlohmann::json make_history_ok(std::string_view req_id,
+                                      std::string_view room,
+                                      size_t count,
+                                      uint64_t before,
+                                      bool more) {
+  nlohmann::json r = {{"v",1},{"type","history_ok"},{"room",room},{"count",count},{"more",more}};
+  if (count) r["before"] = before;
   if (!req_id.empty()) r["req_id"] = req_id;
   return r;
 }
@@ -0,0 +1,246 @@
+#include "core/request_decoder.h"
+#include <cstdint>
+
+namespace core::proto {
+
+namespace {
+
+// JSON 숫자 토큰을 읽은 결과
+struct Number {
+  bool neg = false;
+  bool integer = true;   // 소수점/지수 없음
+  bool overflow = false; // 절댓값이 uint64 를 넘음
+  uint64_t mag = 0;
+};
+
+// 올바른 UTF-8 인지 (DOM 파서와 같은 기준: overlong/서로게이트/범위 초과 거부)
+bool valid_utf8(const unsigned char* p, const unsigned char* end) {
+  while (p < end) {
+    unsigned char c = *p;
+    if (c < 0x80) {
+      p++;
+      continue;
+    }
+    size_t n;
+    unsigned char lo = 0x80, hi = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) n = 1;
+    else if (c == 0xE0) { n = 2; lo = 0xA0; }
+    else if (c == 0xED) { n = 2; hi = 0x9F; }
+    else if (c >= 0xE1 && c <= 0xEF) n = 2;
+    else if (c == 0xF0) { n = 3; lo = 0x90; }
+    else if (c == 0xF4) { n = 3; hi = 0x8F; }
+    else if (c >= 0xF1 && c <= 0xF3) n = 3;
+    else return false;
+    if (static_cast<size_t>(end - p) < n + 1) return false;
+    if (p[1] < lo || p[1] > hi) return false;
+    for (size_t i = 2; i <= n; i++) {
+      if (p[i] < 0x80 || p[i] > 0xBF) return false;
+    }
+    p += n + 1;
+  }
+  return true;
+}
+
+class Cursor {
+public:
+  explicit Cursor(std::string_view s)
+    : p_(reinterpret_cast<const unsigned char*>(s.data())), end_(p_ + s.size()) {}
+
+  bool done() const { return p_ == end_; }
+
+  void skip_ws() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) p_++;
+  }
+
+  bool eat(char c) {
+    if (p_ < end_ && *p_ == static_cast<unsigned char>(c)) {
+      p_++;
+      return true;
+    }
+    return false;
+  }
+
+  int peek() const { return p_ < end_ ? *p_ : -1; }
+
+  // escape 없는 문자열만 (있으면 false -> DOM 으로)
+  bool string(std::string_view& out) {
+    if (!eat('"')) return false;
+    const unsigned char* b = p_;
+    bool ascii = true;
+    for (; p_ < end_; p_++) {
+      unsigned char c = *p_;
+      if (c == '"') break;
+      if (c == '\\' || c < 0x20) return false;
+      if (c >= 0x80) ascii = false;
+    }
+    if (p_ == end_) return false;
+    if (!ascii && !valid_utf8(b, p_)) return false;
+    out = std::string_view(reinterpret_cast<const char*>(b), static_cast<size_t>(p_ - b));
+    p_++; // 닫는 따옴표
+    return true;
+  }
+
+  bool number(Number& n) {
+    n = Number{};
+    n.neg = eat('-');
+    if (p_ == end_) return false;
+    if (*p_ == '0') {
+      p_++;
+    } else if (*p_ >= '1' && *p_ <= '9') {
+      while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+        uint64_t d = *p_++ - '0';
+        if (n.mag > (UINT64_MAX - d) / 10) n.overflow = true;
+        else n.mag = n.mag * 10 + d;
+      }
+    } else {
+      return false;
+    }
+    if (eat('.')) {
+      n.integer = false;
+      if (!digits()) return false;
+    }
+    if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+      p_++;
+      n.integer = false;
+      if (!eat('+')) eat('-');
+      if (!digits()) return false;
+    }
+    return true;
+  }
+
+  bool literal(std::string_view word) {
+    if (static_cast<size_t>(end_ - p_) < word.size()) return false;
+    if (std::string_view(reinterpret_cast<const char*>(p_), word.size()) != word) return false;
+    p_ += word.size();
+    return true;
+  }
+
+private:
+  const unsigned char* p_;
+  const unsigned char* end_;
+
+  bool digits() {
+    const unsigned char* b = p_;
+    while (p_ < end_ && *p_ >= '0' && *p_ <= '9') p_++;
+    return p_ > b;
+  }
+};
+
+// 값 하나. 문자열이면 str 에, 숫자면 num 에 (kind 로 구분), 리터럴은 str 에 그 이름
+enum class Kind { String, Number, Literal };
+
+bool value(Cursor& cur, Kind& kind, std::string_view& str, Number& num) {
+  switch (cur.peek()) {
+    case '"':
+      kind = Kind::String;
+      return cur.string(str);
+    case 't':
+      kind = Kind::Literal;
+      str = "true";
+      return cur.literal("true");
+    case 'f':
+      kind = Kind::Literal;
+      str = "false";
+      return cur.literal("false");
+    case 'n':
+      kind = Kind::Literal;
+      str = "null";
+      return cur.literal("null");
+    default:
+      kind = Kind::Number;
+      return cur.number(num); // '{' '[' 등은 여기서 실패 -> DOM
+  }
+}
+
+UintField uint_field(Kind kind, const Number& n) {
+  UintField f;
+  f.present = true;
+  if (kind == Kind::Number && n.integer && !n.neg && !n.overflow) {
+    f.ok = true;
+    f.value = n.mag;
+  }
+  return f;
+}
+
+std::optional<std::string_view> str_field(Kind kind, std::string_view s) {
+  if (kind != Kind::String) return std::nullopt;
+  return s;
+}
+
+std::optional<bool> bool_field(Kind kind, std::string_view s) {
+  if (kind != Kind::Literal || s == "null") return std::nullopt;
+  return s == "true";
+}
+
+} // namespace
+
+bool decode_request(std::string_view payload, Request& out) {
+  out = Request{};
+  Cursor cur(payload);
+
+  cur.skip_ws();
+  if (!cur.eat('{')) return false;
+  cur.skip_ws();
+  if (!cur.eat('}')) {
+    for (;;) {
+      std::string_view k;
+      cur.skip_ws();
+      if (!cur.string(k)) return false;
+      cur.skip_ws();
+      if (!cur.eat(':')) return false;
+      cur.skip_ws();
+
+      Kind kind;
+      std::string_view s;
+      Number n;
+      if (!value(cur, kind, s, n)) return false;
+
+      // parse_request 와 같은 규칙 (같은 키가 여러 번이면 마지막 것)
+      switch (k.size()) {
+        case 1:
+          if (k == "v" && kind == Kind::Number && n.integer && !n.overflow) {
+            out.v = static_cast<int>(n.neg ? -static_cast<int64_t>(n.mag)
+                                           : static_cast<int64_t>(n.mag));
+          }
+          break;
+        case 3:
+          if (k == "enc") out.enc = str_field(kind, s);
+          break;
+        case 4:
+          if (k == "type") {
+            out.type_name = kind == Kind::String ? s : std::string_view{};
+            out.type = msg_type(out.type_name);
+          } else if (k == "nick") out.nick = str_field(kind, s);
+          else if (k == "text") out.text = str_field(kind, s);
+          else if (k == "room") out.room = str_field(kind, s);
+          break;
+        case 5:
+          if (k == "limit") out.limit = uint_field(kind, n);
+          else if (k == "since") out.since = uint_field(kind, n);
+          else if (k == "batch") out.batch = bool_field(kind, s);
+          break;
+        case 6:
+          if (k == "req_id") out.req_id = kind == Kind::String ? s : std::string_view{};
+          else if (k == "before") out.before = uint_field(kind, n);
+          break;
+        case 8:
+          if (k == "compress") out.compress = str_field(kind, s);
+          break;
+        default:
+          break;
+      }
+
+      cur.skip_ws();
+      if (cur.eat(',')) continue;
+      if (cur.eat('}')) break;
+      return false;
+    }
+  }
+  cur.skip_ws();
+  if (!cur.done()) return false;
+
+  // 모르는/없는 type 은 DOM 경로에서 (에러 처리와 확장 필드를 한 곳에)
+  return out.type != MsgType::Unknown;
+}
+
+} // namespace core::proto
@@ -0,0 +1,16 @@
+#pragma once
+#include <string_view>
+#include "core/protocol.h"
+
+namespace core::proto {
+
+// 수신 프레임을 DOM 없이 Request 로 디코딩 (할당 없음)
+// - 프로토콜 메시지는 평평한 객체라 한 번 훑으면서 필요한 키만 view 로 잡음
+// - 문자열 view 는 payload 를 가리킴 -> payload 가 살아 있는 동안만 유효
+// - 다음 경우는 false: 호출자가 nlohmann DOM 으로 다시 파싱
+//     escape 가 있는 문자열, 중첩 객체/배열, 모르는(또는 없는) type, 형식 오류
+//   (잘못된 JSON 판정은 DOM 쪽에 맡겨 기존 동작과 같게 유지)
+// - true 를 돌려주는 입력은 항상 올바른 JSON 이고 parse_request(DOM) 결과와 같음
+bool decode_request(std::string_view payload, Request& out);
+
+} // namespace core::proto
@@ -0,0 +1,164 @@
+#include "core/room_history.h"
+#include <algorithm>
+
+namespace core {
+
+namespace {
+// 항목당 고정 오버헤드 (슬롯 + 프레임 헤더)
+constexpr size_t kEntryOverhead = 64;
+// 다른 방에서 되찾을 때 한 번에 비우는 최소량 (예산이 찬 동안 매 append 마다 mx_ 를 잡지 않게)
+constexpr size_t kReclaimBatch = 64 * 1024;
+} // namespace
+
+// ---- HistoryBudget ----
+
+bool HistoryBudget::reserve(size_t cost) {
+  size_t cur = bytes_.load(std::memory_order_relaxed);
+  for (;;) {
+    if (cur + cost > max_) return false;
+    if (bytes_.compare_exchange_weak(cur, cur + cost, std::memory_order_relaxed)) return true;
+  }
+}
+
+std::vector<uint32_t> HistoryBudget::take_emptied() {
+  std::vector<uint32_t> out;
+  if (!has_emptied_.load(std::memory_order_relaxed)) return out;
+  std::lock_guard<std::mutex> lk(mx_);
+  out.swap(emptied_);
+  has_emptied_.store(false, std::memory_order_relaxed);
+  return out;
+}
+
+void HistoryBudget::enroll(RoomHistory* h) {
+  std::lock_guard<std::mutex> lk(mx_);
+  if (h->enrolled_) return;
+  h->enrolled_ = true;
+  h->clock_pos_ = clock_.size();
+  clock_.push_back(h);
+}
+
+void HistoryBudget::leave(RoomHistory* h) {
+  std::lock_guard<std::mutex> lk(mx_);
+  if (h->enrolled_) remove_locked_(h);
+}
+
+void HistoryBudget::remove_locked_(RoomHistory* h) {
+  size_t pos = h->clock_pos_;
+  clock_[pos] = clock_.back();
+  clock_[pos]->clock_pos_ = pos;
+  clock_.pop_back();
+  h->enrolled_ = false;
+}
+
+bool HistoryBudget::reclaim(RoomHistory* self, size_t need) {
+  std::lock_guard<std::mutex> lk(mx_);
+  // 첫 바퀴는 recent_ 를 지우며 지나가고 두 번째 바퀴에서 고름 (second chance)
+  for (size_t step = 0, n = clock_.size(); step < 2 * n && !clock_.empty(); step++) {
+    if (hand_ >= clock_.size()) hand_ = 0;
+    RoomHistory* h = clock_[hand_];
+    if (h == self || h->recent_.exchange(false, std::memory_order_relaxed) ||
+        !h->owner_mx_->try_lock()) {
+      hand_++;
+      continue;
+    }
+    std::lock_guard<std::mutex> rlk(*h->owner_mx_, std::adopt_lock);
+    const size_t target = std::max(need, kReclaimBatch);
+    size_t freed = 0;
+    while (h->count_ > 0 && freed < target) {
+      freed += h->ring_[h->head_].cost;
+      h->evict_oldest_();
+    }
+    if (h->count_ == 0) {
+      h->release_slots_();
+      remove_locked_(h); // 마지막 방이 hand_ 자리로 옮겨 옴 -> hand_ 는 그대로
+      emptied_.push_back(h->tag_);
+      has_emptied_.store(true, std::memory_order_relaxed);
+    } else {
+      hand_++;
+    }
+    if (freed > 0) return true;
+  }
+  return false;
+}
+
+// ---- RoomHistory ----
+
+RoomHistory::RoomHistory(const HistoryLimits& lim, HistoryBudget* budget, std::mutex* owner_mx,
+                         uint32_t tag)
+  : lim_(lim), budget_(budget), owner_mx_(owner_mx), tag_(tag) {}
+
+RoomHistory::~RoomHistory() {
+  if (!budget_) return;
+  budget_->leave(this);
+  if (bytes_) budget_->release(bytes_);
+}
+
+void RoomHistory::evict_oldest_() {
+  Entry& e = ring_[head_];
+  bytes_ -= e.cost;
+  if (budget_) budget_->release(e.cost);
+  e.frame.reset();
+  head_ = (head_ + 1) % ring_.size();
+  --count_;
+}
+
+void RoomHistory::release_slots_() {
+  std::vector<Entry>().swap(ring_);
+  head_ = 0;
+}
+
+void RoomHistory::append(uint64_t seq, FramePtr frame) {
+  if (lim_.max_msgs == 0 || !frame) return;
+  const size_t cost = frame->payload_size() + kEntryOverhead;
+  if (cost > lim_.max_bytes) return;
+
+  while (count_ > 0 && (count_ >= lim_.max_msgs || bytes_ + cost > lim_.max_bytes)) {
+    evict_oldest_();
+  }
+  if (budget_) {
+    // 전역 예산이 찼으면: 조용한 다른 방에서 되찾고 -> 안 되면 이 방의 오래된 것
+    // -> 이 방도 비었으면 이번 건은 보관하지 않음
+    while (!budget_->reserve(cost)) {
+      if (budget_->reclaim(this, cost)) continue;
+      if (count_ == 0) return;
+      evict_oldest_();
+    }
+    recent_.store(true, std::memory_order_relaxed);
+    if (!enrolled_) budget_->enroll(this);
+  }
+
+  if (count_ == ring_.size()) {
+    // 슬롯이 모두 찼는데 max_msgs 미만 -> 펼친 뒤 하나 늘림 (max_msgs 까지만 자람)
+    std::rotate(ring_.begin(), ring_.begin() + static_cast<std::ptrdiff_t>(head_), ring_.end());
+    head_ = 0;
+    ring_.push_back(Entry{seq, std::move(frame), cost});
+  } else {
+    Entry& e = ring_[(head_ + count_) % ring_.size()];
+    e = Entry{seq, std::move(frame), cost};
+  }
+  ++count_;
+  bytes_ += cost;
+}
+
+size_t RoomHistory::collect(uint64_t before, size_t limit, std::vector<FramePtr>& out,
+                            uint64_t& first_seq, bool& more) const {
+  first_seq = 0;
+  more = false;
+
+  // seq < before 인 항목 수 (seq 는 오름차순)
+  size_t lo = 0, hi = count_;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (at_(mid).seq < before) lo = mid + 1;
+    else hi = mid;
+  }
+  size_t end = lo;
+  size_t begin = end > limit ? end - limit : 0;
+
+  for (size_t i = begin; i < end; i++) out.push_back(at_(i).frame);
+  if (end > begin) first_seq = at_(begin).seq;
+  more = begin > 0;
+  return end - begin;
+}
+
+} // namespace core
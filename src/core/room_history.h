@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "core/frame.h"
+
+namespace core {
+
+struct HistoryLimits {
+  size_t max_msgs = 200;                      // 방당 보관 메시지 수
+  size_t max_bytes = 256 * 1024;              // 방당 보관 바이트
+  size_t global_max_bytes = 64 * 1024 * 1024; // 모든 방 합계
+  size_t replay_msgs = 50;                    // join/hello 때 다시 보내는 개수
+  size_t page_msgs = 100;                     // history 요청 한 번의 최대 개수
+};
+
+class RoomHistory;
+
+// 모든 방의 RoomHistory 가 나눠 쓰는 전역 바이트 예산 (global_max_bytes)
+// - 기록이 있는 방들을 clock 으로 돌며, 바늘이 한 바퀴 도는 동안 append 가 없던 방(LRU 근사)의
+//   오래된 항목부터 빼서 자리를 만듦 -> 조용한 방들이 예산을 계속 쥐고 있지 못함
+// - append 는 방별 플래그만 세우고 전역 락을 잡지 않음. mx_ 는 예산이 찼을 때와
+//   방의 기록이 비었다가 처음 생길 때만
+// - 다른 방의 락은 try_lock 만: 호출자가 자기 방 락을 쥔 채로 오므로 기다리면 교착 가능
+// - 되찾다가 기록을 다 비운 방은 tag 를 모아 둠 -> 소유자가 take_emptied 로 가져가 정리
+//   (여기서는 방 목록 락을 잡을 수 없으므로)
+class HistoryBudget {
+public:
+  explicit HistoryBudget(size_t max_bytes) : max_(max_bytes) {}
+
+  HistoryBudget(const HistoryBudget&) = delete;
+  HistoryBudget& operator=(const HistoryBudget&) = delete;
+
+  size_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+  // reclaim 이 기록을 다 비운 방들의 tag (가져가면 비워짐)
+  std::vector<uint32_t> take_emptied();
+
+private:
+  friend class RoomHistory;
+
+  bool reserve(size_t cost);
+  void release(size_t cost) { bytes_.fetch_sub(cost, std::memory_order_relaxed); }
+  void enroll(RoomHistory* h); // 소유 방 락 안에서
+  void leave(RoomHistory* h);
+  // self 가 아닌 방에서 need 바이트 이상(그 방이 비면 그만큼) 비움. 비운 게 없으면 false
+  bool reclaim(RoomHistory* self, size_t need);
+  void remove_locked_(RoomHistory* h);
+
+  const size_t max_;
+  std::atomic<size_t> bytes_{0};
+  std::mutex mx_;
+  std::vector<RoomHistory*> clock_; // 기록이 있는 방들
+  size_t hand_ = 0;
+  std::vector<uint32_t> emptied_;
+  std::atomic<bool> has_emptied_{false}; // take_emptied 가 빈 경우 mx_ 를 안 잡게
+};
+
+// 방 하나의 최근 chat 프레임 ring
+// - 팬아웃에 쓴 FramePtr 를 그대로 보관 -> replay 때 재직렬화/복사 없음
+// - 슬롯 배열은 max_msgs 까지 한 번 자라고 이후 덮어씀 (방마다 고정 arena)
+// - 전역 바이트는 HistoryBudget 에서 예약/반납
+//   예약이 안 되면 오래 조용했던 다른 방에서 되찾고, 안 되면 이 방의 오래된 것부터 비우고,
+//   그래도 안 되면 이번 메시지는 보관하지 않음
+// - 스레드 안전하지 않음: 소유 방의 락(owner_mx) 안에서 사용
+//   (HistoryBudget 은 그 락을 try_lock 한 뒤에만 이 방의 항목을 뺌)
+class RoomHistory {
+public:
+  // tag: 비워졌을 때 HistoryBudget::take_emptied 로 돌려줄 값 (소유 방의 id)
+  RoomHistory(const HistoryLimits& lim, HistoryBudget* budget, std::mutex* owner_mx,
+              uint32_t tag = 0);
+  ~RoomHistory();
+
+  RoomHistory(const RoomHistory&) = delete;
+  RoomHistory& operator=(const RoomHistory&) = delete;
+
+  // seq 는 방 안에서 증가해야 함
+  void append(uint64_t seq, FramePtr frame);
+
+  // seq < before 인 것 중 최신 limit 개를 오래된 순으로 out 에 추가
+  // 반환: 추가한 개수. more = 그보다 오래된 것이 남아 있음
+  size_t collect(uint64_t before, size_t limit, std::vector<FramePtr>& out,
+                 uint64_t& first_seq, bool& more) const;
+
+  bool empty() const { return count_ == 0; }
+  size_t size() const { return count_; }
+  size_t bytes() const { return bytes_; }
+
+private:
+  friend class HistoryBudget;
+
+  struct Entry {
+    uint64_t seq = 0;
+    FramePtr frame;
+    size_t cost = 0;
+  };
+
+  const HistoryLimits& lim_;
+  HistoryBudget* budget_;
+  std::mutex* owner_mx_;
+  uint32_t tag_;
+  std::vector<Entry> ring_;
+  size_t head_ = 0;  // 가장 오래된 슬롯
+  size_t count_ = 0;
+  size_t bytes_ = 0;
+
+  // HistoryBudget 용: enrolled_ 는 owner_mx_ 와 budget mx_ 를 모두 잡고 바꿈, clock_pos_ 는 mx_ 안에서만
+  bool enrolled_ = false;
+  size_t clock_pos_ = 0;
+  std::atomic<bool> recent_{false}; // 바늘이 지나간 뒤 append 가 있었음
+
+  const Entry& at_(size_t i) const { return ring_[(head_ + i) % ring_.size()]; }
+  void evict_oldest_();
+  // 전부 비었을 때 슬롯 배열도 반납 (조용한 방이 arena 를 쥐고 있지 않게)
+  void release_slots_();
+};
+
+} // namespace core
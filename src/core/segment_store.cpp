@@ -0,0 +1,687 @@
+#include "core/segment_store.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace core {
+
+namespace {
+
+// 레코드: len(u32) | checksum(u32, payload FNV-1a) | seq(u64) | ts_us(i64) | payload   (LE)
+constexpr size_t kRecHdr = 24;
+// 인덱스 항목: seq(u64) | ts_us(i64) | offset(u64)
+constexpr size_t kIdxEntry = 24;
+
+uint32_t checksum(const char* p, size_t n) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < n; i++) {
+    h ^= static_cast<uint8_t>(p[i]);
+    h *= 16777619u;
+  }
+  return h;
+}
+
+void put_le(char* p, uint64_t v, int bytes) {
+  for (int i = 0; i < bytes; i++) p[i] = static_cast<char>((v >> (8 * i)) & 0xff);
+}
+
+uint64_t get_le(const char* p, int bytes) {
+  uint64_t v = 0;
+  for (int i = 0; i < bytes; i++) v |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+  return v;
+}
+
+// 방 이름은 임의 바이트 -> 디렉터리 이름은 hex
+std::string hex_name(const std::string& s) {
+  static const char* d = "0123456789abcdef";
+  std::string out;
+  out.reserve(s.size() * 2);
+  for (unsigned char c : s) {
+    out += d[c >> 4];
+    out += d[c & 15];
+  }
+  return out;
+}
+
+std::string seg_file(uint64_t base, const char* ext) {
+  char b[40];
+  std::snprintf(b, sizeof(b), "%020llu%s", static_cast<unsigned long long>(base), ext);
+  return b;
+}
+
+int64_t wall_now_us() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+bool pwrite_all(int fd, const char* p, size_t n, size_t off) {
+  while (n > 0) {
+    ssize_t w = ::pwrite(fd, p, n, static_cast<off_t>(off));
+    if (w < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += w;
+    n -= static_cast<size_t>(w);
+    off += static_cast<size_t>(w);
+  }
+  return true;
+}
+
+struct IndexEntry {
+  uint64_t seq;
+  int64_t ts;
+  size_t off;
+};
+
+struct Segment {
+  uint64_t base_seq = 0;
+  std::string path, idx_path;
+  int fd = -1;      // 활성 세그먼트만 열려 있음
+  int idx_fd = -1;
+  char* map = nullptr;
+  size_t cap = 0;   // 매핑 길이 (활성은 미리 잡아 둔 파일 크기)
+  size_t size = 0;  // 유효 바이트
+  uint64_t first_seq = 0, last_seq = 0;
+  int64_t first_ts = 0, last_ts = 0;
+  std::vector<IndexEntry> index;
+  size_t since_index = 0; // 마지막 인덱스 항목 이후 레코드 수
+
+  ~Segment() {
+    if (map) ::munmap(map, cap);
+    if (fd >= 0) ::close(fd);
+    if (idx_fd >= 0) ::close(idx_fd);
+  }
+
+  bool active() const { return fd >= 0; }
+
+  // off 의 레코드가 온전하면 true (payload 위치/길이와 메타를 돌려줌)
+  bool record_at(size_t off, size_t limit, uint64_t& seq, int64_t& ts,
+                 const char*& payload, size_t& len) const {
+    if (off + kRecHdr > limit) return false;
+    const char* h = map + off;
+    len = static_cast<size_t>(get_le(h, 4));
+    if (len == 0 || off + kRecHdr + len > limit) return false;
+    payload = h + kRecHdr;
+    if (checksum(payload, len) != static_cast<uint32_t>(get_le(h + 4, 4))) return false;
+    seq = get_le(h + 8, 8);
+    ts = static_cast<int64_t>(get_le(h + 16, 8));
+    return true;
+  }
+
+  // seq 이하의 가장 가까운 인덱스 오프셋
+  size_t seek_seq(uint64_t seq) const {
+    auto it = std::upper_bound(index.begin(), index.end(), seq,
+                               [](uint64_t s, const IndexEntry& e) { return s < e.seq; });
+    return it == index.begin() ? 0 : std::prev(it)->off;
+  }
+
+  size_t seek_ts(int64_t ts) const {
+    auto it = std::upper_bound(index.begin(), index.end(), ts,
+                               [](int64_t t, const IndexEntry& e) { return t < e.ts; });
+    return it == index.begin() ? 0 : std::prev(it)->off;
+  }
+};
+
+struct PendingRec {
+  uint64_t seq;
+  int64_t ts;
+  size_t off; // pending 버퍼 안 위치
+  size_t len; // 헤더 포함
+};
+
+} // namespace
+
+struct RoomLog {
+  std::string dir;
+
+  // 디스크 쓰기 / 세그먼트 교체 / 읽기 (append 경로는 잡지 않음)
+  std::mutex io_mx;
+  std::vector<std::unique_ptr<Segment>> segs;
+
+  // append 경로: 버퍼에 붙이기만
+  std::mutex mx;
+  std::string pending;
+  std::vector<PendingRec> pending_recs;
+  bool dirty_listed = false;
+
+  std::atomic<uint64_t> first_seq{0}; // 남아 있는 가장 오래된 seq (보존 정책으로 바뀜)
+  std::atomic<uint64_t> last_seq{0};
+};
+
+struct SegmentStore::Impl {
+  SegmentStoreOptions& opt;
+  Stats& st;
+
+  std::mutex rooms_mx;
+  std::unordered_map<std::string, std::shared_ptr<RoomLog>> rooms;
+
+  std::mutex dirty_mx;
+  std::condition_variable cv;
+  std::vector<std::shared_ptr<RoomLog>> dirty;
+  bool kicked = false; // flush_bytes 를 넘긴 방이 있음 -> 주기를 기다리지 않고 씀
+  bool stopping = false;
+  std::thread flusher;
+
+  Impl(SegmentStoreOptions& o, Stats& s) : opt(o), st(s) {}
+
+  std::shared_ptr<RoomLog> room(const std::string& name) {
+    {
+      std::lock_guard<std::mutex> lk(rooms_mx);
+      auto it = rooms.find(name);
+      if (it != rooms.end()) return it->second;
+    }
+    // 디렉터리 훑기/매핑은 rooms_mx 밖에서; 동시에 연 쪽이 있으면 먼저 등록된 것을 씀
+    auto fresh = std::make_shared<RoomLog>();
+    fresh->dir = (std::filesystem::path(opt.dir) / hex_name(name)).string();
+    open_room(*fresh);
+    std::lock_guard<std::mutex> lk(rooms_mx);
+    auto& slot = rooms[name];
+    if (!slot) slot = std::move(fresh);
+    return slot;
+  }
+
+  // 세그먼트를 매핑하고 마지막 인덱스 이후를 검증해 유효 끝을 찾음
+  std::unique_ptr<Segment> open_segment(const std::filesystem::path& p, uint64_t base, bool last) {
+    auto s = std::make_unique<Segment>();
+    s->base_seq = base;
+    s->path = p.string();
+    s->idx_path = p.parent_path() / seg_file(base, ".idx");
+
+    int fd = ::open(s->path.c_str(), last ? O_RDWR : O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat stt{};
+    if (::fstat(fd, &stt) != 0) {
+      ::close(fd);
+      return nullptr;
+    }
+    s->cap = static_cast<size_t>(stt.st_size);
+    if (s->cap > 0) {
+      void* m = ::mmap(nullptr, s->cap, PROT_READ, MAP_SHARED, fd, 0);
+      if (m == MAP_FAILED) {
+        ::close(fd);
+        return nullptr;
+      }
+      s->map = static_cast<char*>(m);
+    }
+    if (last) s->fd = fd;
+    else ::close(fd);
+
+    // 인덱스 로드 (가리키는 레코드가 유효한 항목만)
+    int ifd = ::open(s->idx_path.c_str(), last ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (ifd >= 0) {
+      struct stat ist{};
+      if (::fstat(ifd, &ist) == 0 && ist.st_size > 0) {
+        std::string buf(static_cast<size_t>(ist.st_size), '\0');
+        ssize_t r = ::pread(ifd, &buf[0], buf.size(), 0);
+        size_t n = r > 0 ? static_cast<size_t>(r) / kIdxEntry : 0;
+        for (size_t i = 0; i < n; i++) {
+          const char* e = buf.data() + i * kIdxEntry;
+          IndexEntry ie{get_le(e, 8), static_cast<int64_t>(get_le(e + 8, 8)),
+                        static_cast<size_t>(get_le(e + 16, 8))};
+          uint64_t sq; int64_t ts; const char* pl; size_t len;
+          if (!s->record_at(ie.off, s->cap, sq, ts, pl, len) || sq != ie.seq) break;
+          s->index.push_back(ie);
+        }
+      }
+    }
+
+    // 첫 레코드
+    {
+      uint64_t sq; int64_t ts; const char* pl; size_t len;
+      if (s->record_at(0, s->cap, sq, ts, pl, len)) {
+        s->first_seq = sq;
+        s->first_ts = ts;
+      }
+    }
+
+    // 마지막 인덱스 이후만 훑어 유효 끝/마지막 레코드를 찾음
+    size_t off = s->index.empty() ? 0 : s->index.back().off;
+    size_t since = 0;
+    uint64_t prev_seq = 0;
+    for (;;) {
+      uint64_t sq; int64_t ts; const char* pl; size_t len;
+      if (!s->record_at(off, s->cap, sq, ts, pl, len) || (prev_seq && sq <= prev_seq)) break;
+      s->last_seq = sq;
+      s->last_ts = ts;
+      prev_seq = sq;
+      off += kRecHdr + len;
+      since++;
+    }
+    s->size = off;
+    s->since_index = since % std::max<size_t>(opt.index_every, 1);
+
+    if (!last) {
+      // 봉인된 세그먼트는 파일 끝까지 유효해야 함
+      if (s->size < s->cap) st.truncated_tails.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      // 꼬리를 정리하지 못하면 이어 쓰지 않고 읽기 전용으로 둠 (다음 기록은 새 세그먼트로)
+      bool ok = true;
+      if (s->size < s->cap && s->map[s->size] != 0) {
+        // 찢어진 꼬리: 잘랐다가 다시 늘려 0 으로 채움 (이어 쓴 뒤 찌꺼기가 레코드로 보이지 않게)
+        st.truncated_tails.fetch_add(1, std::memory_order_relaxed);
+        ok = ::ftruncate(s->fd, static_cast<off_t>(s->size)) == 0 &&
+             ::ftruncate(s->fd, static_cast<off_t>(s->cap)) == 0;
+      }
+      // 잘린 인덱스 꼬리 정리 후 이어 쓰기
+      if (ok && ifd >= 0) {
+        ok = ::ftruncate(ifd, static_cast<off_t>(s->index.size() * kIdxEntry)) == 0;
+        if (ok) {
+          ::lseek(ifd, 0, SEEK_END);
+          s->idx_fd = ifd;
+          ifd = -1;
+        }
+      }
+      if (!ok) {
+        st.io_errors.fetch_add(1, std::memory_order_relaxed);
+        ::close(s->fd);
+        s->fd = -1;
+      }
+    }
+    if (ifd >= 0) ::close(ifd);
+    return s;
+  }
+
+  void open_room(RoomLog& rl) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_directory(rl.dir, ec)) return;
+
+    std::vector<std::pair<uint64_t, fs::path>> files;
+    for (auto& de : fs::directory_iterator(rl.dir, ec)) {
+      if (de.path().extension() != ".seg") continue;
+      try {
+        files.emplace_back(std::stoull(de.path().stem().string()), de.path());
+      } catch (...) {}
+    }
+    std::sort(files.begin(), files.end());
+
+    for (size_t i = 0; i < files.size(); i++) {
+      bool last = i + 1 == files.size();
+      auto s = open_segment(files[i].second, files[i].first, last);
+      if (!s) continue;
+      if (s->size == 0) {
+        // 빈 세그먼트 (생성 직후 종료): 지움
+        s.reset();
+        fs::remove(files[i].second, ec);
+        fs::remove(files[i].second.parent_path() / seg_file(files[i].first, ".idx"), ec);
+        continue;
+      }
+      rl.segs.push_back(std::move(s));
+    }
+    if (!rl.segs.empty()) {
+      rl.first_seq.store(rl.segs.front()->first_seq, std::memory_order_relaxed);
+      rl.last_seq.store(rl.segs.back()->last_seq, std::memory_order_relaxed);
+    }
+  }
+
+  void seal(Segment& s) {
+    if (!s.active()) return;
+    if (opt.fsync) ::fdatasync(s.fd);
+    // 못 줄여도 size 뒤는 미리 잡아 둔 0 이라 다시 열 때 꼬리로 잘림
+    if (::ftruncate(s.fd, static_cast<off_t>(s.size)) != 0)
+      st.io_errors.fetch_add(1, std::memory_order_relaxed);
+    if (s.map) ::munmap(s.map, s.cap);
+    s.map = nullptr;
+    s.cap = s.size;
+    if (s.size > 0) {
+      void* m = ::mmap(nullptr, s.size, PROT_READ, MAP_SHARED, s.fd, 0);
+      if (m != MAP_FAILED) s.map = static_cast<char*>(m);
+      else s.cap = 0;
+    }
+    ::close(s.fd);
+    s.fd = -1;
+    if (s.idx_fd >= 0) {
+      ::close(s.idx_fd);
+      s.idx_fd = -1;
+    }
+  }
+
+  Segment* create_segment(RoomLog& rl, uint64_t base, size_t need) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(rl.dir, ec);
+
+    auto s = std::make_unique<Segment>();
+    s->base_seq = base;
+    s->path = (fs::path(rl.dir) / seg_file(base, ".seg")).string();
+    s->idx_path = (fs::path(rl.dir) / seg_file(base, ".idx")).string();
+    s->fd = ::open(s->path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (s->fd < 0) return nullptr;
+    s->cap = std::max(opt.segment_bytes, need);
+    // 파일을 미리 잡아 두고(sparse) 한 번만 매핑
+    if (::ftruncate(s->fd, static_cast<off_t>(s->cap)) != 0) return nullptr;
+    void* m = ::mmap(nullptr, s->cap, PROT_READ, MAP_SHARED, s->fd, 0);
+    if (m == MAP_FAILED) return nullptr;
+    s->map = static_cast<char*>(m);
+    s->idx_fd = ::open(s->idx_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+
+    rl.segs.push_back(std::move(s));
+    st.segments_created.fetch_add(1, std::memory_order_relaxed);
+    retire(rl);
+    return rl.segs.back().get();
+  }
+
+  // 보존 정책: 활성 세그먼트를 제외하고 오래된 것부터 삭제
+  void retire(RoomLog& rl) {
+    const int64_t cutoff = opt.max_age_sec
+      ? wall_now_us() - static_cast<int64_t>(opt.max_age_sec) * 1000000 : INT64_MIN;
+    while (rl.segs.size() > 1) {
+      Segment& s = *rl.segs.front();
+      bool too_many = rl.segs.size() > opt.max_segments;
+      bool too_old = s.last_ts < cutoff;
+      if (!too_many && !too_old) break;
+      std::error_code ec;
+      std::filesystem::remove(s.path, ec);
+      std::filesystem::remove(s.idx_path, ec);
+      rl.segs.erase(rl.segs.begin());
+      // 새로 만든 활성 세그먼트만 남았으면 아직 레코드가 없음: 곧 쓸 첫 레코드가 base_seq
+      const Segment& f = *rl.segs.front();
+      rl.first_seq.store(f.first_seq ? f.first_seq : f.base_seq, std::memory_order_relaxed);
+      st.segments_retired.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // 새 레코드 need 바이트를 받을 활성 세그먼트 (필요하면 봉인 후 새로 만듦)
+  Segment* active_for(RoomLog& rl, uint64_t seq, size_t need) {
+    Segment* s = rl.segs.empty() ? nullptr : rl.segs.back().get();
+    if (s && s->active() && s->size + need <= s->cap) return s;
+    if (s) seal(*s);
+    return create_segment(rl, seq, need);
+  }
+
+  void note_record(Segment& s, const PendingRec& r, size_t off) {
+    if (s.first_seq == 0) {
+      s.first_seq = r.seq;
+      s.first_ts = r.ts;
+    }
+    s.last_seq = r.seq;
+    s.last_ts = r.ts;
+    if (s.since_index == 0) {
+      s.index.push_back(IndexEntry{r.seq, r.ts, off});
+      if (s.idx_fd >= 0) {
+        char e[kIdxEntry];
+        put_le(e, r.seq, 8);
+        put_le(e + 8, static_cast<uint64_t>(r.ts), 8);
+        put_le(e + 16, off, 8);
+        if (::write(s.idx_fd, e, sizeof(e)) != static_cast<ssize_t>(sizeof(e))) {}
+      }
+    }
+    s.since_index = (s.since_index + 1) % std::max<size_t>(opt.index_every, 1);
+  }
+
+  // io_mx 를 잡은 상태에서 호출
+  void flush(RoomLog& rl) {
+    std::string buf;
+    std::vector<PendingRec> recs;
+    {
+      std::lock_guard<std::mutex> lk(rl.mx);
+      buf.swap(rl.pending);
+      recs.swap(rl.pending_recs);
+      rl.dirty_listed = false;
+    }
+
+    size_t i = 0;
+    while (i < recs.size()) {
+      Segment* s = active_for(rl, recs[i].seq, recs[i].len);
+      if (!s) return; // 디스크 오류: 이번 배치는 버림
+
+      size_t j = i, bytes = 0;
+      while (j < recs.size() && s->size + bytes + recs[j].len <= s->cap) bytes += recs[j++].len;
+      if (!pwrite_all(s->fd, buf.data() + recs[i].off, bytes, s->size)) return;
+
+      size_t base_off = s->size;
+      for (size_t k = i; k < j; k++) note_record(*s, recs[k], base_off + (recs[k].off - recs[i].off));
+      s->size += bytes;
+      st.flushed_bytes.fetch_add(bytes, std::memory_order_relaxed);
+      if (opt.fsync) ::fdatasync(s->fd);
+      i = j;
+    }
+  }
+
+  void run() {
+    auto last_retire = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lk(dirty_mx);
+    for (;;) {
+      // 주기만큼 모아서 쓰기 (flush_bytes 를 넘긴 방이 깨운 경우는 바로)
+      // dirty 가 차 있다고 바로 깨지 않음: 직전 flush 중에 쌓인 것도 다음 주기까지 모음
+      cv.wait_for(lk, std::chrono::milliseconds(opt.flush_ms),
+                  [this] { return stopping || kicked; });
+      kicked = false;
+      std::vector<std::shared_ptr<RoomLog>> batch;
+      batch.swap(dirty);
+      bool stop_now = stopping;
+      lk.unlock();
+
+      for (auto& rl : batch) {
+        std::lock_guard<std::mutex> io(rl->io_mx);
+        flush(*rl);
+      }
+
+      // 나이 기반 보존은 쓰기가 없는 방에도 적용
+      auto now = std::chrono::steady_clock::now();
+      if (opt.max_age_sec && now - last_retire > std::chrono::seconds(60)) {
+        last_retire = now;
+        std::vector<std::shared_ptr<RoomLog>> all;
+        {
+          std::lock_guard<std::mutex> rk(rooms_mx);
+          for (auto& kv : rooms) all.push_back(kv.second);
+        }
+        for (auto& rl : all) {
+          std::lock_guard<std::mutex> io(rl->io_mx);
+          retire(*rl);
+        }
+      }
+
+      lk.lock();
+      if (stop_now && dirty.empty()) break;
+    }
+  }
+
+  // 아직 버퍼에 있는 레코드 중 keep 인 것을 앞에서부터 max 개 복사 (rl.mx 는 복사 동안만)
+  // io_mx 를 잡은 상태에서 호출: 그동안 flush 가 버퍼를 디스크로 옮기지 못하므로
+  // 디스크에서 읽은 것과 겹치거나 빠지는 레코드가 없음
+  template <class Keep>
+  void copy_pending(RoomLog& rl, size_t max, Keep keep, std::string& buf,
+                    std::vector<PendingRec>& recs) {
+    std::lock_guard<std::mutex> lk(rl.mx);
+    for (const PendingRec& r : rl.pending_recs) {
+      if (recs.size() >= max) break;
+      if (!keep(r)) continue;
+      recs.push_back(PendingRec{r.seq, r.ts, buf.size(), r.len});
+      buf.append(rl.pending, r.off, r.len);
+    }
+  }
+
+  size_t emit_pending(const std::string& buf, const std::vector<PendingRec>& recs,
+                      const RecordFn& fn) {
+    for (const PendingRec& r : recs) {
+      fn(r.seq, r.ts, std::string_view(buf.data() + r.off + kRecHdr, r.len - kRecHdr));
+    }
+    return recs.size();
+  }
+
+  // seq < before 를 찾아 [start, before) 를 앞에서부터 (io_mx 잡은 상태)
+  size_t read_range(RoomLog& rl, uint64_t start, uint64_t before, const RecordFn& fn) {
+    size_t n = 0;
+    for (auto& sp : rl.segs) {
+      Segment& s = *sp;
+      if (s.last_seq < start) continue;
+      if (s.first_seq >= before) break;
+      size_t off = s.seek_seq(start);
+      uint64_t sq; int64_t ts; const char* pl; size_t len;
+      while (off < s.size && s.record_at(off, s.size, sq, ts, pl, len)) {
+        off += kRecHdr + len;
+        if (sq < start) continue;
+        if (sq >= before) return n;
+        fn(sq, ts, std::string_view(pl, len));
+        n++;
+      }
+    }
+    return n;
+  }
+};
+
+SegmentStore::SegmentStore(SegmentStoreOptions opt)
+  : opt_(std::move(opt)), impl_(std::make_unique<Impl>(opt_, stats_)) {}
+
+SegmentStore::~SegmentStore() {
+  stop();
+}
+
+bool SegmentStore::supported() {
+  return true;
+}
+
+bool SegmentStore::start() {
+  std::error_code ec;
+  std::filesystem::create_directories(opt_.dir, ec);
+  if (ec) return false;
+  if (impl_->flusher.joinable()) return true;
+  impl_->stopping = false;
+  impl_->flusher = std::thread([this] { impl_->run(); });
+  return true;
+}
+
+void SegmentStore::stop() {
+  if (!impl_->flusher.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lk(impl_->dirty_mx);
+    impl_->stopping = true;
+  }
+  impl_->cv.notify_one();
+  impl_->flusher.join();
+}
+
+SegmentStore::RoomRef SegmentStore::open(const std::string& room) {
+  return impl_->room(room);
+}
+
+void SegmentStore::append(const RoomRef& rl, uint64_t seq, int64_t ts_us,
+                          std::string_view payload) {
+  if (!rl || payload.empty()) return;
+
+  bool kick = false;
+  bool list = false;
+  {
+    std::lock_guard<std::mutex> lk(rl->mx);
+    size_t off = rl->pending.size();
+    rl->pending.resize(off + kRecHdr + payload.size());
+    char* h = &rl->pending[off];
+    put_le(h, payload.size(), 4);
+    put_le(h + 4, checksum(payload.data(), payload.size()), 4);
+    put_le(h + 8, seq, 8);
+    put_le(h + 16, static_cast<uint64_t>(ts_us), 8);
+    std::memcpy(h + kRecHdr, payload.data(), payload.size());
+    rl->pending_recs.push_back(PendingRec{seq, ts_us, off, kRecHdr + payload.size()});
+    rl->last_seq.store(seq, std::memory_order_relaxed);
+    uint64_t none = 0;
+    rl->first_seq.compare_exchange_strong(none, seq, std::memory_order_relaxed);
+
+    kick = rl->pending.size() >= opt_.flush_bytes;
+    if (!rl->dirty_listed) {
+      rl->dirty_listed = true;
+      list = true;
+    }
+  }
+  stats_.appended.fetch_add(1, std::memory_order_relaxed);
+
+  if (list || kick) {
+    std::lock_guard<std::mutex> lk(impl_->dirty_mx);
+    if (list) impl_->dirty.push_back(rl);
+    if (kick) impl_->kicked = true;
+  }
+  if (kick) impl_->cv.notify_one();
+}
+
+uint64_t SegmentStore::first_seq(const RoomRef& rl) const {
+  return rl ? rl->first_seq.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t SegmentStore::last_seq(const RoomRef& rl) const {
+  return rl ? rl->last_seq.load(std::memory_order_relaxed) : 0;
+}
+
+size_t SegmentStore::read_before(const RoomRef& rl, uint64_t before, size_t limit,
+                                 const RecordFn& fn) {
+  if (!rl || limit == 0) return 0;
+  std::lock_guard<std::mutex> io(rl->io_mx);
+
+  uint64_t last = rl->last_seq.load(std::memory_order_relaxed);
+  if (before > last + 1) before = last + 1;
+  // 방 안의 seq 는 연속이므로 시작 seq 를 바로 계산해 인덱스로 찾음
+  uint64_t start = before > limit ? before - limit : 0;
+  // 디스크에 있는 것이 버퍼에 있는 것보다 항상 오래됨 -> 매핑 먼저, 그다음 버퍼
+  size_t n = impl_->read_range(*rl, start, before, fn);
+  std::string buf;
+  std::vector<PendingRec> recs;
+  impl_->copy_pending(*rl, limit - std::min(n, limit),
+                      [&](const PendingRec& r) { return r.seq >= start && r.seq < before; },
+                      buf, recs);
+  return n + impl_->emit_pending(buf, recs, fn);
+}
+
+size_t SegmentStore::read_since(const RoomRef& rl, int64_t since_us, size_t limit,
+                                const RecordFn& fn) {
+  if (!rl || limit == 0) return 0;
+  std::lock_guard<std::mutex> io(rl->io_mx);
+
+  size_t n = 0;
+  for (auto& sp : rl->segs) {
+    Segment& s = *sp;
+    if (s.last_ts < since_us) continue;
+    size_t off = s.seek_ts(since_us);
+    uint64_t sq; int64_t ts; const char* pl; size_t len;
+    while (off < s.size && s.record_at(off, s.size, sq, ts, pl, len)) {
+      off += kRecHdr + len;
+      if (ts < since_us) continue;
+      fn(sq, ts, std::string_view(pl, len));
+      if (++n >= limit) return n;
+    }
+  }
+  std::string buf;
+  std::vector<PendingRec> recs;
+  impl_->copy_pending(*rl, limit - n, [&](const PendingRec& r) { return r.ts >= since_us; },
+                      buf, recs);
+  return n + impl_->emit_pending(buf, recs, fn);
+}
+
+} // namespace core
+
+#else // _WIN32
+
+namespace core {
+
+struct SegmentStore::Impl {};
+
+SegmentStore::SegmentStore(SegmentStoreOptions opt) : opt_(std::move(opt)) {}
+SegmentStore::~SegmentStore() = default;
+bool SegmentStore::supported() { return false; }
+bool SegmentStore::start() { return false; }
+void SegmentStore::stop() {}
+SegmentStore::RoomRef SegmentStore::open(const std::string&) { return nullptr; }
+void SegmentStore::append(const RoomRef&, uint64_t, int64_t, std::string_view) {}
+uint64_t SegmentStore::first_seq(const RoomRef&) const { return 0; }
+uint64_t SegmentStore::last_seq(const RoomRef&) const { return 0; }
+size_t SegmentStore::read_before(const RoomRef&, uint64_t, size_t, const RecordFn&) { return 0; }
+size_t SegmentStore::read_since(const RoomRef&, int64_t, size_t, const RecordFn&) { return 0; }
+
+} // namespace core
+
+#endif
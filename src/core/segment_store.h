@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace core {
+
+struct RoomLog;
+
+struct SegmentStoreOptions {
+  std::string dir = "data/history";     // <dir>/<hex(room)>/<base_seq>.seg|.idx
+  size_t segment_bytes = 8 * 1024 * 1024; // 세그먼트 크기 (이보다 큰 레코드는 단독 세그먼트)
+  size_t index_every = 64;              // 레코드 N 개마다 sparse 인덱스 한 항목
+  unsigned flush_ms = 100;              // write-behind 주기
+  size_t flush_bytes = 256 * 1024;      // 방 하나의 대기 바이트가 이만큼이면 바로 flush
+  size_t max_segments = 64;             // 방당 보관 세그먼트 수 (넘으면 오래된 것부터 삭제)
+  uint64_t max_age_sec = 0;             // 0 = 나이 제한 없음
+  bool fsync = false;                   // flush 마다 fdatasync
+};
+
+// 방별 append-only 세그먼트 로그 (chat 기록 영속화)
+// - append() 는 방별 메모리 버퍼에 붙이기만 함 (write-behind); 백그라운드 스레드가 pwrite
+// - 세그먼트는 mmap 으로 읽음: 재시작 직후 "최근 N 개" 도 page cache 에서 바로 읽힘
+// - .idx 파일에 sparse 인덱스 (seq, ts, offset) -> seq/시간으로 탐색
+// - 보존 정책은 세그먼트 단위 삭제 (개수/나이)
+// - 방 하나는 open() 이 돌려주는 RoomRef 로 다룸: 호출자가 들고 있으면 append 는 전역 락/이름
+//   해시 없이 그 방의 버퍼 락만 잡음
+// - 읽기는 flush 하지 않음: 디스크의 것은 매핑에서, 아직 버퍼에 있는 것은 버퍼에서 복사해 읽음
+//   (쓰기 중인 flush 스레드와는 방의 io 락을 두고만 겨룸. append 는 디스크 I/O 를 기다리지 않음)
+// - 열 때 마지막 인덱스 이후만 검증해 찢어진 꼬리(비정상 종료)를 잘라냄
+// - POSIX 전용 (mmap/pwrite); 그 외 플랫폼은 start() 가 false
+class SegmentStore {
+public:
+  using RoomRef = std::shared_ptr<RoomLog>;
+  // payload 는 콜백 동안만 유효 (매핑된 메모리)
+  using RecordFn = std::function<void(uint64_t seq, int64_t ts_us, std::string_view payload)>;
+
+  struct Stats {
+    std::atomic<uint64_t> appended{0};
+    std::atomic<uint64_t> flushed_bytes{0};
+    std::atomic<uint64_t> segments_created{0};
+    std::atomic<uint64_t> segments_retired{0};
+    std::atomic<uint64_t> truncated_tails{0}; // 열 때 잘라낸 찢어진 꼬리
+    std::atomic<uint64_t> io_errors{0};       // ftruncate 실패 (해당 세그먼트는 더 이어 쓰지 않음)
+  };
+
+  explicit SegmentStore(SegmentStoreOptions opt = {});
+  ~SegmentStore();
+
+  SegmentStore(const SegmentStore&) = delete;
+  SegmentStore& operator=(const SegmentStore&) = delete;
+
+  bool start();
+  // 대기 중인 기록을 모두 쓰고 flush 스레드 종료
+  void stop();
+
+  static bool supported();
+
+  // 방의 로그를 찾거나 엶 (처음이면 디렉터리를 훑고 세그먼트를 매핑: 전역 락 밖에서)
+  RoomRef open(const std::string& room);
+
+  void append(const RoomRef& room, uint64_t seq, int64_t ts_us, std::string_view payload);
+
+  // 둘 다 락 없이 읽음
+  uint64_t first_seq(const RoomRef& room) const; // 0 = 기록 없음
+  uint64_t last_seq(const RoomRef& room) const;  // 0 = 기록 없음
+
+  // seq < before 인 것 중 최신 limit 개를 오래된 순으로. 반환: 개수
+  size_t read_before(const RoomRef& room, uint64_t before, size_t limit, const RecordFn& fn);
+  // ts >= since_us 인 것부터 limit 개. 반환: 개수
+  size_t read_since(const RoomRef& room, int64_t since_us, size_t limit, const RecordFn& fn);
+
+  const Stats& stats() const { return stats_; }
+
+private:
+  SegmentStoreOptions opt_;
+  Stats stats_;
+
+  // pimpl (cpp 에서만 POSIX 의존)
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace core
@@ -0,0 +1,57 @@
+#include "core/symbol_table.h"
+
+namespace core {
+
+const std::string& Symbol::str() const {
+  static const std::string empty;
+  return e_ ? e_->name : empty;
+}
+
+void Symbol::reset() {
+  Entry* e = e_;
+  e_ = nullptr;
+  if (e && e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) e->table->release(e);
+}
+
+Symbol SymbolTable::intern(std::string_view name) {
+  std::lock_guard<std::mutex> lk(mx_);
+  auto it = by_name_.find(name);
+  if (it != by_name_.end()) {
+    // refs 가 0 이어도 (반납 직전) 여기서 되살림 -> release 가 다시 확인하고 건너뜀
+    it->second->refs.fetch_add(1, std::memory_order_relaxed);
+    return Symbol(it->second);
+  }
+
+  Entry* e = nullptr;
+  if (!free_.empty()) {
+    e = free_.back();
+    free_.pop_back();
+  } else {
+    entries_.push_back(std::make_unique<Entry>());
+    e = entries_.back().get();
+    e->id = static_cast<SymId>(entries_.size());
+    e->table = this;
+  }
+  e->name.assign(name);
+  e->live = true;
+  e->refs.store(1, std::memory_order_relaxed);
+  by_name_.emplace(e->name, e);
+  return Symbol(e);
+}
+
+void SymbolTable::release(Entry* e) {
+  std::lock_guard<std::mutex> lk(mx_);
+  if (!e->live || e->refs.load(std::memory_order_acquire) != 0) return;
+  by_name_.erase(e->name);
+  e->live = false;
+  e->name.clear();
+  e->name.shrink_to_fit();
+  free_.push_back(e);
+}
+
+size_t SymbolTable::size() const {
+  std::lock_guard<std::mutex> lk(mx_);
+  return by_name_.size();
+}
+
+} // namespace core
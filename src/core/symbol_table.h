@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace core {
+
+using SymId = uint32_t; // 0 = 빈 심볼
+
+class SymbolTable;
+
+// 인터닝된 이름 (방/닉) 핸들
+// - 같은 이름은 같은 id 와 같은 문자열 하나를 공유 -> 비교/해시는 id 로
+// - 참조 카운트: 복사는 원자 증가만 (테이블 락 없음), 마지막 핸들이 사라지면 id 반납
+// - str() 은 핸들이 살아 있는 동안 주소가 고정 (직렬화/로그에서 복사 없이 씀)
+class Symbol {
+public:
+  Symbol() = default;
+  Symbol(const Symbol& o) : e_(o.e_) { retain(); }
+  Symbol(Symbol&& o) noexcept : e_(o.e_) { o.e_ = nullptr; }
+  Symbol& operator=(const Symbol& o) {
+    if (e_ != o.e_) {
+      Symbol tmp(o);
+      std::swap(e_, tmp.e_);
+    }
+    return *this;
+  }
+  Symbol& operator=(Symbol&& o) noexcept {
+    std::swap(e_, o.e_);
+    return *this;
+  }
+  ~Symbol() { reset(); }
+
+  SymId id() const { return e_ ? e_->id : 0; }
+  const std::string& str() const;
+  explicit operator bool() const { return e_ != nullptr; }
+  bool operator==(const Symbol& o) const { return e_ == o.e_; }
+  bool operator!=(const Symbol& o) const { return e_ != o.e_; }
+
+  void reset();
+
+private:
+  friend class SymbolTable;
+  struct Entry {
+    SymId id = 0;
+    std::string name;
+    std::atomic<uint32_t> refs{0};
+    SymbolTable* table = nullptr;
+    bool live = false; // false = 반납되어 free 목록에 있음
+  };
+
+  explicit Symbol(Entry* e) : e_(e) {} // 참조는 호출자가 이미 올림
+  void retain() {
+    if (e_) e_->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Entry* e_ = nullptr;
+};
+
+// 이름 -> Symbol. intern 만 락을 잡음 (방 입장/닉 변경 같은 드문 경로)
+// 테이블은 모든 Symbol 보다 오래 살아야 함
+class SymbolTable {
+public:
+  SymbolTable() = default;
+  SymbolTable(const SymbolTable&) = delete;
+  SymbolTable& operator=(const SymbolTable&) = delete;
+
+  Symbol intern(std::string_view name);
+  size_t size() const; // 살아 있는 심볼 수
+
+private:
+  friend class Symbol;
+  using Entry = Symbol::Entry;
+
+  // 참조가 0 이 된 항목을 반납 (그 사이 다시 intern 됐으면 그대로 둠)
+  void release(Entry* e);
+
+  mutable std::mutex mx_;
+  std::vector<std::unique_ptr<Entry>> entries_; // index = id - 1, 항목 주소는 고정
+  std::vector<Entry*> free_;                    // 반납된 항목 (id 재사용)
+  std::unordered_map<std::string_view, Entry*> by_name_; // key 는 Entry::name 을 가리킴
+};
+
+} // namespace core
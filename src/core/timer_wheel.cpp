@@ -0,0 +1,77 @@
+#include "core/timer_wheel.h"
+
+namespace core {
+
+TimerWheel::TimerWheel(uint64_t now_tick) : base_(now_tick) {
+  for (auto& level : slots_) {
+    for (Timer& head : level) head.prev = head.next = &head;
+  }
+}
+
+void TimerWheel::link_(Timer* t) {
+  if (t->expires < base_) t->expires = base_;
+  uint64_t diff = t->expires - base_;
+  if (diff >= kSpan) {
+    t->expires = base_ + kSpan - 1;
+    diff = kSpan - 1;
+  }
+
+  int level = 0;
+  while (level + 1 < kLevels && diff >= (uint64_t{1} << (kBits * (level + 1)))) level++;
+  Timer& head = slots_[level][(t->expires >> (kBits * level)) & kMask];
+
+  t->prev = head.prev;
+  t->next = &head;
+  head.prev->next = t;
+  head.prev = t;
+}
+
+void TimerWheel::unlink_(Timer* t) {
+  t->prev->next = t->next;
+  t->next->prev = t->prev;
+  t->prev = t->next = nullptr;
+}
+
+void TimerWheel::schedule(Timer* t, uint64_t expires_tick) {
+  if (t->linked()) unlink_(t);
+  else size_++;
+  t->expires = expires_tick;
+  link_(t);
+}
+
+void TimerWheel::cancel(Timer* t) {
+  if (!t->linked()) return;
+  unlink_(t);
+  size_--;
+}
+
+void TimerWheel::cascade_(int level) {
+  Timer& head = slots_[level][(base_ >> (kBits * level)) & kMask];
+  Timer* t = head.next;
+  head.prev = head.next = &head;
+  while (t != &head) {
+    Timer* next = t->next;
+    link_(t); // base_ 기준으로 다시 나누면 아래 레벨로 내려감
+    t = next;
+  }
+}
+
+TimerWheel::Timer* TimerWheel::step_() {
+  // 레벨 0 이 한 바퀴 돌았으면 위 레벨 슬롯을 내림 (위 레벨도 한 바퀴면 그 위까지)
+  for (int level = 1; level < kLevels; level++) {
+    if ((base_ >> (kBits * (level - 1))) & kMask) break;
+    cascade_(level);
+  }
+
+  Timer& head = slots_[0][base_ & kMask];
+  base_++;
+  if (head.next == &head) return nullptr;
+
+  Timer* first = head.next;
+  head.prev->next = nullptr; // 단방향 체인으로 떼어 냄
+  head.prev = head.next = &head;
+  for (Timer* t = first; t; t = t->next) size_--;
+  return first;
+}
+
+} // namespace core
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace core {
+
+// 계층형 타이머 휠: 레벨 4개 x 슬롯 64개 (tick 단위, 2^24 tick 까지)
+// - 타이머는 사용자 구조체에 넣는 intrusive 노드 -> schedule/cancel 이 O(1), 할당 없음
+// - advance 는 지난 tick 마다 레벨 0 슬롯 하나를 비움. 레벨 0 이 한 바퀴 돌 때마다
+//   위 레벨의 슬롯 하나를 아래로 다시 나눔(cascade) -> 타이머당 재배치는 최대 레벨 수만큼
+// - 2^24 tick 보다 먼 만료는 그 끝으로 당김
+// 스레드 안전하지 않음: 소유자의 락 안에서 사용
+class TimerWheel {
+public:
+  struct Timer {
+    Timer* prev = nullptr;
+    Timer* next = nullptr;
+    uint64_t expires = 0; // tick
+    bool linked() const { return prev != nullptr; }
+  };
+
+  explicit TimerWheel(uint64_t now_tick = 0);
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // 이미 걸려 있으면 옮김. 지난 tick 이면 다음 advance 에서 만료
+  void schedule(Timer* t, uint64_t expires_tick);
+  void cancel(Timer* t);
+
+  // now_tick 까지 만료된 타이머마다 fn(Timer*) (호출 시점에 이미 휠에서 빠져 있음)
+  // fn 안에서 그 타이머를 다시 schedule 해도 됨 (같은 tick 에 만료된 다른 타이머는 건드리지 말 것)
+  template <class Fn>
+  void advance(uint64_t now_tick, Fn&& fn) {
+    while (base_ <= now_tick) {
+      Timer* t = step_();
+      while (t) {
+        Timer* next = t->next;
+        t->prev = t->next = nullptr;
+        fn(t);
+        t = next;
+      }
+    }
+  }
+
+  uint64_t now() const { return base_; } // 다음에 처리할 tick
+  size_t size() const { return size_; }
+
+private:
+  static constexpr int kLevels = 4;
+  static constexpr int kBits = 6;
+  static constexpr size_t kSlots = size_t{1} << kBits;
+  static constexpr uint64_t kMask = kSlots - 1;
+  static constexpr uint64_t kSpan = uint64_t{1} << (kBits * kLevels);
+
+  // 슬롯 = 원형 리스트의 머리 (빈 슬롯은 자기 자신을 가리킴)
+  void link_(Timer* t);
+  void unlink_(Timer* t);
+  void cascade_(int level);
+  // base_ tick 의 레벨 0 슬롯을 통째로 떼어 내 (cascade 후) 반환하고 base_++
+  Timer* step_();
+
+  std::array<std::array<Timer, kSlots>, kLevels> slots_;
+  uint64_t base_;
+  size_t size_ = 0;
+};
+
+} // namespace core
@@ -1,7 +1,17 @@
 #include "net/net_platform.h"
 #include <sstream>
+#ifndef _WIN32
+#include <netinet/tcp.h>
+#endif
 
 namespace net {
+
+#if defined(MSG_NOSIGNAL)
+static constexpr int kNoSigPipe = MSG_NOSIGNAL;
+#else
+static constexpr int kNoSigPipe = 0;
+#endif
+
 bool init() {
 #ifdef _WIN32
     WSADATA wsa;
@@ -39,6 +49,19 @@ void close_socket(socket_t s) {
 #endif
 }
 
+void shutdown_socket(socket_t s) {
+#ifdef _WIN32
+    shutdown(s, SD_BOTH);
+#else
+    shutdown(s, SHUT_RDWR);
+#endif
+}
+
+void set_nodelay(socket_t s) {
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+}
+
 bool send_all(socket_t s, const uint8_t* data, size_t len) {
     size_t sent = 0;
     while(sent < len) {
@@ -46,7 +69,7 @@ bool send_all(socket_t s, const uint8_t* data, size_t len) {
             int n = ::send(s, reinterpret_cast<const char*>(data + sent),
                             static_cast<int>(len - sent), 0);
         #else
-            ssize_t n = ::send(s, data + sent, len - sent, 0);
+            ssize_t n = ::send(s, data + sent, len - sent, kNoSigPipe);
         #endif
             if(n <= 0) return false;
             sent += static_cast<size_t> (n);
@@ -54,6 +77,47 @@ bool send_all(socket_t s, const uint8_t* data, size_t len) {
     return true;
 }
 
+bool send_all_v(socket_t s, IoSlice* slices, size_t count) {
+    size_t i = 0;
+    while (i < count) {
+        if (slices[i].len == 0) { i++; continue; }
+    #ifdef _WIN32
+        WSABUF bufs[16];
+        DWORD nb = 0;
+        for (size_t k = i; k < count && nb < 16; k++, nb++) {
+            bufs[nb].buf = reinterpret_cast<CHAR*>(const_cast<uint8_t*>(slices[k].data));
+            bufs[nb].len = static_cast<ULONG>(slices[k].len);
+        }
+        DWORD sent = 0;
+        if (WSASend(s, bufs, nb, &sent, 0, nullptr, nullptr) != 0) return false;
+        size_t n = sent;
+    #else
+        iovec iov[64];
+        size_t cnt = 0;
+        for (size_t k = i; k < count && cnt < 64; k++, cnt++) {
+            iov[cnt].iov_base = const_cast<uint8_t*>(slices[k].data);
+            iov[cnt].iov_len = slices[k].len;
+        }
+        msghdr mh{};
+        mh.msg_iov = iov;
+        mh.msg_iovlen = cnt;
+        ssize_t r = ::sendmsg(s, &mh, kNoSigPipe);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        size_t n = static_cast<size_t>(r);
+    #endif
+        // 보낸 만큼 slice 를 앞으로 당김 (부분 전송 대비)
+        while (n > 0 && i < count) {
+            size_t take = n < slices[i].len ? n : slices[i].len;
+            slices[i].data += take;
+            slices[i].len -= take;
+            n -= take;
+            if (slices[i].len == 0) i++;
+        }
+    }
+    return true;
+}
+
 bool recv_exact(socket_t s, uint8_t* data, size_t len) {
     size_t got = 0;
     while(got < len) {
@@ -69,4 +133,24 @@ bool recv_exact(socket_t s, uint8_t* data, size_t len) {
     return true;
 }
 
+long long recv_some(socket_t s, uint8_t* data, size_t len) {
+    for (;;) {
+        #ifdef WIN32
+            int n = ::recv(s, reinterpret_cast<char*>(data), static_cast<int>(len), 0);
+        #else
+            ssize_t n = ::recv(s, data, len, 0);
+            if (n < 0 && errno == EINTR) continue;
+        #endif
+        return static_cast<long long>(n);
+    }
+}
+
+bool would_block(int err) {
+#ifdef _WIN32
+    return err == WSAEWOULDBLOCK;
+#else
+    return err == EAGAIN || err == EWOULDBLOCK;
+#endif
+}
+
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
     #include <sys/socket.h>
     #include <netinet/in.h>
     #include <arpa/inet.h>
+    #include <sys/uio.h>
     #include <unistd.h>
     #include <errno.h>
 #endif
@@ -31,8 +32,23 @@ namespace net {
     std::string last_error_string();
 
     void close_socket(socket_t sock);
+    // 양방향 shutdown: 다른 스레드에서 막혀 있는 recv/send 를 깨움 (fd 는 그대로)
+    void shutdown_socket(socket_t sock);
+    // Nagle 끄기: 작은 프레임을 바로 내보내야 하는 중계 링크용
+    void set_nodelay(socket_t sock);
 
     // 전송/수신 유틸
     bool send_all(socket_t sock, const uint8_t* data, size_t len);
+
+    // 여러 버퍼를 syscall 한 번(sendmsg / WSASend)으로 전송. 전부 보낼 때까지 반복
+    struct IoSlice {
+        const uint8_t* data;
+        size_t len;
+    };
+    bool send_all_v(socket_t sock, IoSlice* slices, size_t count);
     bool recv_exact(socket_t s, uint8_t* data, size_t len);
+
+    // recv 1회. >0: 받은 바이트, 0: 상대가 닫음, <0: 에러 (would_block 으로 EAGAIN 구분)
+    long long recv_some(socket_t s, uint8_t* data, size_t len);
+    bool would_block(int err);
 }
\ No newline at end of file
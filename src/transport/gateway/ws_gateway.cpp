@@ -1,16 +1,18 @@
 #include "transport/gateway/ws_gateway.h"
 
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <sstream>
-#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <boost/beast/websocket.hpp>
 
-#include "net/net_platform.h"
-#include "common/framing.h"
+#include "common/frame_decoder.h"
+#include "common/mux_frame.h"
 
 namespace asio = boost::asio;
 namespace beast = boost::beast;
@@ -19,138 +21,756 @@ using tcp = asio::ip::tcp;
 
 namespace transport::gateway {
 
-struct WsGateway::Impl {
-  asio::io_context ioc;
-  tcp::acceptor acceptor{ioc};
-  std::thread th;
-  int ws_port = 0;
+namespace {
 
-  std::string tcp_host;
-  int tcp_port = 0;
+std::string peer_name(const tcp::socket& s) {
+  std::ostringstream oss;
+  beast::error_code ec;
+  auto ep = s.remote_endpoint(ec);
+  if (ec) return "unknown";
+  oss << ep.address().to_string() << ":" << ep.port();
+  return oss.str();
+}
 
-  std::atomic<bool>* running = nullptr;
+constexpr auto kReconnectDelay = std::chrono::seconds(1);
 
-  explicit Impl(std::string host, int port, std::atomic<bool>* r)
-      : tcp_host(std::move(host)), tcp_port(port), running(r) {}
+// 종료 때 남은 핸들러를 버리는 io_context
+// 세션과 링크는 서로 다른 io_context 의 소켓/타이머를 붙잡으므로, io_context 를 하나씩 소멸시키면
+// 앞서 사라진 io_context 의 객체를 뒤늦게 해제하게 됨 -> 모두 살아 있을 때 핸들러부터 버림
+class IoContext : public asio::io_context {
+public:
+  using asio::io_context::io_context;
+  void drop_handlers() { shutdown(); }
+};
 
-  static net::socket_t connect_tcp_raw(const std::string& host, int port) {
-    if (!net::init()) return net::INVALID_SOCKET_FD;
+// 서버 -> 클라이언트 WS 프레임 헤더 (마스크 없음, FIN, 조각내지 않음)
+size_t ws_header_bytes(size_t n) { return n < 126 ? 2 : n <= 0xFFFF ? 4 : 10; }
+
+void put_ws_header(std::string& out, bool text, size_t n) {
+  char h[10];
+  size_t len = 2;
+  h[0] = static_cast<char>(0x80 | (text ? 0x1 : 0x2));
+  if (n < 126) {
+    h[1] = static_cast<char>(n);
+  } else if (n <= 0xFFFF) {
+    h[1] = 126;
+    h[2] = static_cast<char>(n >> 8);
+    h[3] = static_cast<char>(n);
+    len = 4;
+  } else {
+    h[1] = 127;
+    for (int k = 0; k < 8; k++) h[2 + k] = static_cast<char>(uint64_t(n) >> (56 - 8 * k));
+    len = 10;
+  }
+  out.append(h, len);
+}
 
-    net::socket_t s = ::socket(AF_INET, SOCK_STREAM, 0);
-    if (s == net::INVALID_SOCKET_FD) return net::INVALID_SOCKET_FD;
+// websocket::stream 밑에 까는 송신 큐 계층
+// - 데이터 프레임은 세션이 헤더까지 만들어 write_raw 로 묶음째 넘김 (Beast 를 거치지 않음 -> 복사 없음)
+// - Beast 가 직접 쓰는 것(handshake 응답, pong, close)도 같은 큐로: 소켓 write 는 한 번에 하나라
+//   두 쪽 프레임이 섞이지 않음
+// - 어느 쪽이든 버퍼를 복사하지 않고 가리키기만 함 -> 완료(소켓에 다 써짐)까지 버퍼를 살려 둬야 함
+//   (Beast 의 write 는 원래 그렇고, 세션은 완료 뒤에 묶음 버퍼를 비움)
+// - teardown 은 큐가 다 나간 뒤 (close 프레임보다 shutdown 이 먼저 나가지 않게)
+// - 소켓/큐는 Core 에 두고 소켓 write 핸들러가 Core 를 붙잡음 (세션이 먼저 사라져도 안전)
+class QueuedSocket {
+public:
+  using executor_type = tcp::socket::executor_type;
+  using Done = std::function<void(beast::error_code)>;
+
+  explicit QueuedSocket(tcp::socket sock) : c_(std::make_shared<Core>(std::move(sock))) {}
+
+  executor_type get_executor() { return c_->sock.get_executor(); }
+  tcp::socket& next_layer() { return c_->sock; }
+
+  // 게이트웨이 종료용 (루프가 멈춘 뒤): 완료 대기자가 붙잡은 세션도 놓음
+  void close(beast::error_code& ec) {
+    c_->dones.clear();
+    c_->wdones.clear();
+    c_->sock.close(ec);
+  }
 
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(static_cast<uint16_t>(port));
-#ifdef _WIN32
-    addr.sin_addr.S_un.S_addr = inet_addr(host.c_str());
-#else
-    inet_pton(AF_INET, host.c_str(), &addr.sin_addr);
-#endif
+  // buf 를 큐에 넣고 소켓에 다 써지면 done(ec) (비어 있으면 앞선 것이 다 나간 뒤)
+  // done 은 이 함수 안에서 바로 불릴 수도 있음
+  void write_raw(asio::const_buffer buf, Done done) {
+    if (buf.size() > 0 && !c_->ec) c_->bufs.push_back(buf);
+    c_->dones.push_back(std::move(done));
+    flush(c_);
+  }
 
-    if (::connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
-      net::close_socket(s);
-      return net::INVALID_SOCKET_FD;
-    }
-    return s;
-  }
-
-  void run_accept_loop() {
-    while (running->load()) {
-      beast::error_code ec;
-      tcp::socket sock{ioc};
-      acceptor.accept(sock, ec);
-      if (!running->load()) break;
-      if (ec) continue;
-
-      std::thread([this](tcp::socket client_sock) {
-        try {
-          auto ws = std::make_shared<websocket::stream<tcp::socket>>(std::move(client_sock));
-          ws->set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
-          ws->accept();
-
-          // 내부 TCP 서버 연결(클라 1명당 TCP 1연결)
-          net::socket_t tcp_s = connect_tcp_raw(tcp_host, tcp_port);
-          if (tcp_s == net::INVALID_SOCKET_FD) {
-            std::string err = R"({"v":1,"type":"error","code":"TCP_CONNECT_FAIL","text":"failed to connect tcp backend"})";
-            ws->text(true);
-            ws->write(asio::buffer(err));
-            beast::error_code ec2;
-            ws->close(websocket::close_code::normal, ec2);
-            return;
-          }
+  template <class Buffers, class Handler>
+  auto async_read_some(const Buffers& bufs, Handler&& handler) {
+    return c_->sock.async_read_some(bufs, std::forward<Handler>(handler));
+  }
 
-          std::mutex ws_write_mx;
-          std::atomic<bool> alive{true};
-
-          // TCP -> WS thread
-          std::thread t_tcp_to_ws([&]() {
-            try {
-              while (alive.load() && running->load()) {
-                std::string payload;
-                if (!framing::recv_message(tcp_s, payload)) break;
-                std::lock_guard<std::mutex> lk(ws_write_mx);
-                if (!ws->is_open()) break;
-                ws->text(true);
-                ws->write(asio::buffer(payload));
-              }
-            } catch (...) {}
-            alive = false;
+  template <class Buffers, class Handler>
+  auto async_write_some(const Buffers& bufs, Handler&& handler) {
+    return asio::async_initiate<Handler, void(beast::error_code, size_t)>(
+        [c = c_](auto h, const Buffers& bufs) {
+          auto ex = c->sock.get_executor();
+          size_t n = 0;
+          if (!c->ec) {
+            for (auto it = asio::buffer_sequence_begin(bufs); it != asio::buffer_sequence_end(bufs);
+                 ++it) {
+              asio::const_buffer b(*it);
+              if (b.size() == 0) continue;
+              c->bufs.push_back(b);
+              n += b.size();
+            }
+          }
+          auto hp = std::make_shared<decltype(h)>(std::move(h));
+          c->dones.push_back([ex, hp, n](beast::error_code ec) {
+            asio::post(ex, beast::bind_front_handler(std::move(*hp), ec, ec ? size_t(0) : n));
           });
+          flush(c);
+        },
+        handler, bufs);
+  }
 
-          // WS -> TCP loop (this thread)
-          beast::flat_buffer buffer;
-          while (alive.load() && running->load() && ws->is_open()) {
-            buffer.clear();
-            ws->read(buffer);
-            std::string payload = beast::buffers_to_string(buffer.data());
-            if (!framing::send_message(tcp_s, payload)) break;
-          }
+private:
+  struct Core {
+    explicit Core(tcp::socket s) : sock(std::move(s)) {}
+    tcp::socket sock;
+    std::vector<asio::const_buffer> bufs; // 아직 소켓에 안 넘긴 것
+    std::vector<Done> dones;
+    std::vector<asio::const_buffer> wbufs; // 소켓 write 중 (bufs 와 맞바꿔 쓰므로 용량 재사용)
+    std::vector<Done> wdones;
+    bool writing = false;
+    beast::error_code ec; // 소켓 write 실패 -> 이후 write 는 모두 이 에러로
+  };
+
+  static void flush(const std::shared_ptr<Core>& c) {
+    if (c->writing) return;
+    if (c->bufs.empty()) {
+      // 쓸 것 없이 기다리던 쪽 (teardown, 이미 실패한 소켓)
+      std::vector<Done> ds;
+      ds.swap(c->dones);
+      for (auto& fn : ds) fn(c->ec);
+      return;
+    }
+    c->writing = true;
+    c->wbufs.swap(c->bufs);
+    c->wdones.swap(c->dones);
+    asio::async_write(c->sock, c->wbufs, [c](beast::error_code ec, size_t) {
+      c->writing = false;
+      c->wbufs.clear();
+      if (ec) {
+        c->ec = ec;
+        c->bufs.clear();
+      }
+      std::vector<Done> ds;
+      ds.swap(c->wdones);
+      for (auto& fn : ds) fn(c->ec);
+      ds.clear();
+      c->wdones.swap(ds); // 용량 재사용
+      flush(c);
+    });
+  }
 
-          alive = false;
-          net::close_socket(tcp_s);
-          if (t_tcp_to_ws.joinable()) t_tcp_to_ws.join();
+  std::shared_ptr<Core> c_;
+};
+
+// websocket::stream<QueuedSocket> 의 close 가 부름 (ADL)
+template <class Handler>
+void async_teardown(beast::role_type role, QueuedSocket& s, Handler&& handler) {
+  auto hp = std::make_shared<std::decay_t<Handler>>(std::forward<Handler>(handler));
+  tcp::socket& sock = s.next_layer();
+  s.write_raw(asio::const_buffer(), [role, &sock, hp](beast::error_code) {
+    beast::websocket::async_teardown(role, sock, std::move(*hp));
+  });
+}
+
+} // namespace
+
+// 백엔드 링크 하나 (자기 io_context 에서 돎)
+// - 채널 테이블/송신 큐는 mx_ 로 보호: 세션들은 다른 io_context 에서 open/send/close 를 부름
+// - 송신은 한 번에 하나의 async_write 가 큐에 쌓인 프레임을 모두 gather 로 보냄
+//   데이터 프레임 = 8B 헤더 + 세션이 넘긴 flat_buffer (payload 는 복사하지 않음)
+//   다 쓰면 보낸 세션에 바이트 수를 돌려줌 (세션의 읽기 재개 기준)
+// - 수신은 디코더 버퍼에 바로 읽고, 데이터 프레임은 채널의 세션으로 (여기서 1번 복사),
+//   서버의 Close 는 세션 종료로 넘김 (세션이 끝나며 보내는 Close 가 곧 답)
+class BackendLink : public std::enable_shared_from_this<BackendLink> {
+public:
+  BackendLink(asio::io_context& ioc, tcp::endpoint ep, size_t index, WsGateway::Impl* owner)
+      : sock_(ioc), retry_(ioc), ep_(std::move(ep)), index_(index), owner_(owner),
+        decoder_(256 * 1024, framing::kMaxFrameSize, mux::kChannelBytes) {}
+
+  void start() { do_connect(); }
+  void stop();
+
+  bool up() const { return up_.load(std::memory_order_acquire); }
+
+  // 채널을 만들고 Open 을 보냄. 링크가 끊겨 있으면 0
+  uint32_t open(const std::shared_ptr<GwSession>& s, const std::string& peer);
+  // data 를 넘겨받아 보냄. 다 쓰였거나 버려지면 from->on_sent
+  void send(uint32_t ch, beast::flat_buffer&& data, std::shared_ptr<GwSession> from);
+  // Close 를 보내고 채널을 뺌 (이미 빠졌으면 아무것도 안 함)
+  void close(uint32_t ch);
+
+private:
+  struct Out {
+    uint8_t head[mux::kHeaderBytes];
+    beast::flat_buffer data;
+    std::string ctrl;                // 컨트롤 프레임 (헤더 포함, data 는 비어 있음)
+    std::shared_ptr<GwSession> from; // 데이터 프레임을 넘긴 세션
+  };
+
+  void do_connect();
+  void do_read();
+  void on_frame(uint32_t ch, std::string_view payload);
+  void push_locked(Out out);
+  void push_control_locked(mux::Op op, uint32_t ch, std::string_view info = {});
+  void do_write();
+  // 다 썼거나 버린 데이터 프레임을 세션별로 모아 알림 (락 밖에서)
+  void release(std::vector<Out>& outs);
+  void fail();
+
+  tcp::socket sock_;
+  asio::steady_timer retry_;
+  tcp::endpoint ep_;
+  size_t index_;
+  WsGateway::Impl* owner_;
+  std::atomic<bool> up_{false};
+
+  // 링크 io_context 전용
+  framing::FrameDecoder decoder_;
+  std::vector<Out> inflight_;
+  std::vector<asio::const_buffer> bufs_;
+  std::unordered_map<GwSession*, std::pair<std::shared_ptr<GwSession>, size_t>> sent_;
+
+  std::mutex mx_;
+  std::unordered_map<uint32_t, std::weak_ptr<GwSession>> chans_;
+  std::vector<Out> wq_;
+  bool writing_ = false;
+  uint32_t next_ch_ = 0; // 재연결해도 이어서 매김 (끊기기 전 채널과 섞이지 않게)
+};
+
+// WS 클라이언트 하나 = 링크 위의 채널 하나
+class GwSession : public std::enable_shared_from_this<GwSession> {
+public:
+  GwSession(tcp::socket sock, WsGateway::Impl* owner)
+      : peer_(peer_name(sock)), ws_(std::move(sock)), owner_(owner) {}
+  ~GwSession();
+
+  void start();
+  // 링크 스레드에서 호출
+  void deliver(std::string_view payload);
+  void remote_close();
+  void on_sent(size_t n);
+  // 게이트웨이 종료: io_context 가 멈춘 뒤 호출
+  void abort();
+
+private:
+  void on_handshake(beast::error_code ec);
+  void reject();
+  void do_read();
+  void on_read(beast::error_code ec);
+  void drain_inbox();
+  void start_batch();
+  void end_batch();
+  void evict();
+  void finish();
+
+  std::string peer_;
+  websocket::stream<QueuedSocket> ws_;
+  beast::flat_buffer buf_;
+  WsGateway::Impl* owner_;
+  std::shared_ptr<BackendLink> link_;
+  uint32_t ch_ = 0;
+  std::atomic<bool> done_{false};
+  std::atomic<bool> evicted_{false};
+  bool closing_ = false;
+
+  // 세션 io_context 전용
+  std::string out_buf_; // 지금 쓰는 묶음 (WS 프레임들, 소켓에 다 써질 때까지 그대로)
+  bool writing_ = false;
+  size_t pending_ = 0; // 링크에 넘겼지만 아직 소켓에 안 써진 바이트
+  bool paused_ = false;
+
+  // 링크 -> 세션: 받은 메시지를 WS 프레임(헤더 + payload)으로 이어 붙여 두고 post 는 한 번만
+  // (in_buf_ 와 out_buf_ 를 맞바꿔 쓰므로 메시지마다 할당하지 않음, payload 복사는 여기 1번)
+  std::mutex in_mx_;
+  std::string in_buf_;
+  bool in_posted_ = false;
+  // in_buf_ + out_buf_ 바이트, 헤더 포함 (client_max_bytes 비교). 묶음은 소켓에 다 써진 뒤에 뺌
+  std::atomic<size_t> out_bytes_{0};
+};
+
+struct WsGateway::Impl {
+  // io_context 마다 스레드 하나. acceptor 는 첫 io_context, 세션은 라운드로빈,
+  // 링크 i 는 io_context (i % n)
+  std::vector<std::unique_ptr<IoContext>> iocs;
+  std::vector<asio::executor_work_guard<asio::io_context::executor_type>> guards;
+  std::vector<std::thread> threads;
+  size_t next_ioc = 0;
+  std::unique_ptr<tcp::acceptor> acceptor;
+  std::unique_ptr<asio::steady_timer> accept_backoff;
+
+  std::vector<std::shared_ptr<BackendLink>> links;
+  std::atomic<size_t> next_link{0};
+
+  std::mutex sess_mx;
+  std::unordered_map<GwSession*, std::weak_ptr<GwSession>> sessions; // 살아 있는 세션 (소멸자에서 빠짐), 종료 시 정리용
+
+  WsGatewayOptions opt;
+  WsGatewayStats* stats = nullptr;
+  std::atomic<bool>* running = nullptr;
 
-          beast::error_code ec3;
-          if (ws->is_open()) ws->close(websocket::close_code::normal, ec3);
-        } catch (...) {
-          // ignore
-        }
-      }, std::move(sock)).detach();
+  Impl(WsGatewayOptions o, WsGatewayStats* st, std::atomic<bool>* r)
+      : opt(o), stats(st), running(r) {}
+
+  // 살아 있는 링크를 라운드로빈으로 (없으면 nullptr)
+  std::shared_ptr<BackendLink> pick_link() {
+    size_t start = next_link.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < links.size(); i++) {
+      auto& l = links[(start + i) % links.size()];
+      if (l->up()) return l;
     }
+    return nullptr;
+  }
+
+  void do_accept() {
+    asio::io_context& target = *iocs[next_ioc++ % iocs.size()];
+    acceptor->async_accept(target, [this](beast::error_code ec, tcp::socket sock) {
+      if (!running->load()) return;
+      if (ec) {
+        // fd 고갈(EMFILE) 등: 잠깐 쉬었다가 다시 (바로 재시도하면 루프가 돎)
+        accept_backoff->expires_after(std::chrono::milliseconds(100));
+        accept_backoff->async_wait([this](beast::error_code) {
+          if (running->load()) do_accept();
+        });
+        return;
+      }
+      auto s = std::make_shared<GwSession>(std::move(sock), this);
+      {
+        std::lock_guard<std::mutex> lk(sess_mx);
+        sessions.emplace(s.get(), s);
+      }
+      s->start();
+      do_accept();
+    });
+  }
+
+  void forget(GwSession* s) {
+    std::lock_guard<std::mutex> lk(sess_mx);
+    sessions.erase(s);
   }
 };
 
-WsGateway::WsGateway(std::string tcp_host, int tcp_port)
-    : tcp_host_(std::move(tcp_host)), tcp_port_(tcp_port) {}
+// ---- BackendLink ----
+
+void BackendLink::do_connect() {
+  sock_.async_connect(ep_, [self = shared_from_this()](beast::error_code ec) {
+    if (!self->owner_->running->load()) return;
+    if (ec) {
+      self->fail();
+      return;
+    }
+    beast::error_code ig;
+    self->sock_.set_option(tcp::no_delay(true), ig);
+    self->up_ = true;
+    std::cout << "gateway link " << self->index_ << " connected\n";
+    self->do_read();
+  });
+}
+
+void BackendLink::do_read() {
+  size_t space = 0;
+  uint8_t* p = decoder_.prepare(16 * 1024, space);
+  sock_.async_read_some(asio::buffer(p, space), [self = shared_from_this()](beast::error_code ec,
+                                                                            size_t n) {
+    if (ec) {
+      self->fail();
+      return;
+    }
+    self->decoder_.commit(n);
+    std::string_view payload;
+    uint32_t ch = 0;
+    while (self->decoder_.next(payload, &ch)) self->on_frame(ch, payload);
+    if (self->decoder_.error()) {
+      self->fail();
+      return;
+    }
+    self->do_read();
+  });
+}
+
+void BackendLink::on_frame(uint32_t ch, std::string_view payload) {
+  bool close = false;
+  if (ch == mux::kControl) {
+    mux::Op op;
+    std::string_view info;
+    if (!mux::parse_control(payload, op, ch, info) || op != mux::Op::Close) return;
+    close = true;
+  }
+
+  std::shared_ptr<GwSession> s;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    auto it = chans_.find(ch);
+    if (it == chans_.end()) return;
+    s = it->second.lock();
+  }
+  if (!s) return;
+  if (close) s->remote_close();
+  else s->deliver(payload);
+}
+
+uint32_t BackendLink::open(const std::shared_ptr<GwSession>& s, const std::string& peer) {
+  std::lock_guard<std::mutex> lk(mx_);
+  if (!up()) return 0;
+  if (++next_ch_ == mux::kControl) ++next_ch_;
+  uint32_t ch = next_ch_;
+  chans_.emplace(ch, s);
+  push_control_locked(mux::Op::Open, ch, peer);
+  return ch;
+}
+
+void BackendLink::send(uint32_t ch, beast::flat_buffer&& data, std::shared_ptr<GwSession> from) {
+  Out out;
+  mux::put_header(out.head, ch, data.size());
+  out.data = std::move(data);
+  out.from = std::move(from);
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (up() && chans_.count(ch)) {
+      push_locked(std::move(out));
+      return;
+    }
+  }
+  out.from->on_sent(out.data.size()); // 채널이 이미 닫힘: 버림
+}
+
+void BackendLink::close(uint32_t ch) {
+  std::lock_guard<std::mutex> lk(mx_);
+  if (!chans_.erase(ch)) return;
+  push_control_locked(mux::Op::Close, ch);
+}
+
+void BackendLink::push_control_locked(mux::Op op, uint32_t ch, std::string_view info) {
+  Out out;
+  out.ctrl = mux::control(op, ch, info);
+  push_locked(std::move(out));
+}
+
+void BackendLink::push_locked(Out out) {
+  if (!up()) return;
+  wq_.push_back(std::move(out));
+  if (writing_) return;
+  writing_ = true;
+  asio::post(sock_.get_executor(), [self = shared_from_this()] { self->do_write(); });
+}
+
+void BackendLink::do_write() {
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (wq_.empty() || !up()) {
+      writing_ = false;
+      return;
+    }
+    inflight_.swap(wq_);
+  }
+  // 헤더와 payload 를 따로 두고 writev 한 번 (scatter-gather)
+  bufs_.clear();
+  for (auto& o : inflight_) {
+    if (!o.ctrl.empty()) {
+      bufs_.push_back(asio::buffer(o.ctrl));
+      continue;
+    }
+    bufs_.push_back(asio::buffer(o.head));
+    bufs_.push_back(o.data.data());
+  }
+  asio::async_write(sock_, bufs_, [self = shared_from_this()](beast::error_code ec, size_t) {
+    self->release(self->inflight_);
+    if (ec) {
+      {
+        std::lock_guard<std::mutex> lk(self->mx_);
+        self->writing_ = false;
+      }
+      self->fail();
+      return;
+    }
+    self->do_write();
+  });
+}
+
+void BackendLink::release(std::vector<Out>& outs) {
+  for (auto& o : outs) {
+    if (!o.from) continue;
+    auto& e = sent_[o.from.get()];
+    if (!e.first) e.first = std::move(o.from);
+    e.second += o.data.size();
+  }
+  outs.clear();
+  for (auto& [_, e] : sent_) e.first->on_sent(e.second);
+  sent_.clear();
+}
+
+void BackendLink::fail() {
+  bool was_up = up_.exchange(false);
+  beast::error_code ig;
+  sock_.close(ig);
+
+  // 끊긴 링크 위의 클라이언트는 모두 닫음 (채널 번호는 다시 쓰지 않음)
+  std::vector<std::shared_ptr<GwSession>> orphans;
+  std::vector<Out> dropped;
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    for (auto& [_, w] : chans_) {
+      if (auto s = w.lock()) orphans.push_back(std::move(s));
+    }
+    chans_.clear();
+    dropped.swap(wq_);
+  }
+  release(dropped);
+  for (auto& s : orphans) s->remote_close();
+  if (was_up) std::cerr << "gateway link " << index_ << " lost, reconnecting\n";
+
+  if (!owner_->running->load()) return;
+  decoder_ = framing::FrameDecoder(256 * 1024, framing::kMaxFrameSize, mux::kChannelBytes);
+  retry_.expires_after(kReconnectDelay);
+  retry_.async_wait([self = shared_from_this()](beast::error_code ec) {
+    if (ec || !self->owner_->running->load()) return;
+    self->do_connect();
+  });
+}
+
+void BackendLink::stop() {
+  up_ = false;
+  beast::error_code ig;
+  retry_.cancel();
+  sock_.close(ig);
+  std::lock_guard<std::mutex> lk(mx_);
+  chans_.clear();
+  wq_.clear();
+  // 루프가 멈춰 write 완료가 오지 않음: 붙잡은 세션을 놓음 (세션도 이 링크를 붙잡고 있음)
+  inflight_.clear();
+  sent_.clear();
+}
+
+// ---- GwSession ----
+
+GwSession::~GwSession() { owner_->forget(this); }
+
+void GwSession::start() {
+  beast::error_code ig;
+  beast::get_lowest_layer(ws_).set_option(tcp::no_delay(true), ig);
+  ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+  ws_.read_message_max(framing::kMaxFrameSize);
+  ws_.async_accept([self = shared_from_this()](beast::error_code ec) { self->on_handshake(ec); });
+}
+
+void GwSession::on_handshake(beast::error_code ec) {
+  if (ec) {
+    done_ = true;
+    return;
+  }
+  link_ = owner_->pick_link();
+  if (link_) ch_ = link_->open(shared_from_this(), peer_);
+  if (!ch_) {
+    reject();
+    return;
+  }
+  do_read();
+}
+
+// 붙을 링크가 없음: 에러 한 줄을 보내고 닫음
+void GwSession::reject() {
+  done_ = true;
+  auto err = std::make_shared<std::string>(
+      R"({"v":1,"type":"error","code":"TCP_CONNECT_FAIL","text":"no tcp backend link"})");
+  ws_.text(true);
+  ws_.async_write(asio::buffer(*err), [self = shared_from_this(), err](beast::error_code ec,
+                                                                       size_t) {
+    if (ec) return;
+    self->ws_.async_close(websocket::close_code::try_again_later, [self](beast::error_code) {});
+  });
+}
+
+void GwSession::do_read() {
+  ws_.async_read(buf_, [self = shared_from_this()](beast::error_code ec, size_t) {
+    self->on_read(ec);
+  });
+}
+
+void GwSession::on_read(beast::error_code ec) {
+  if (ec) {
+    finish();
+    return;
+  }
+  // 읽은 버퍼를 통째로 링크에 넘기고 다음 메시지는 새 버퍼로 (복사 없음)
+  pending_ += buf_.size();
+  owner_->stats->to_backend.fetch_add(1, std::memory_order_relaxed);
+  link_->send(ch_, std::move(buf_), shared_from_this());
+  buf_ = beast::flat_buffer();
+  // 링크가 밀리면 이 클라이언트의 읽기를 멈춤 (on_sent 에서 재개)
+  if (pending_ > owner_->opt.backend_max_bytes) {
+    paused_ = true;
+    owner_->stats->read_pauses.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  do_read();
+}
+
+void GwSession::on_sent(size_t n) {
+  asio::post(ws_.get_executor(), [self = shared_from_this(), n] {
+    self->pending_ -= n;
+    if (!self->paused_ || self->pending_ > self->owner_->opt.backend_max_bytes / 2) return;
+    self->paused_ = false;
+    if (!self->done_) self->do_read();
+  });
+}
+
+void GwSession::deliver(std::string_view payload) {
+  if (done_ || evicted_) return;
+  const size_t n = payload.size();
+  const size_t wire = ws_header_bytes(n) + n;
+  if (out_bytes_.fetch_add(wire, std::memory_order_relaxed) + wire > owner_->opt.client_max_bytes) {
+    evict();
+    return;
+  }
+  owner_->stats->to_clients.fetch_add(1, std::memory_order_relaxed);
+  bool post;
+  {
+    std::lock_guard<std::mutex> lk(in_mx_);
+    // v2(MessagePack) 프레임은 바이너리로 (JSON 객체는 항상 '{' 로 시작)
+    put_ws_header(in_buf_, n > 0 && payload[0] == '{', n);
+    in_buf_.append(payload.data(), n);
+    post = !in_posted_;
+    in_posted_ = true;
+  }
+  if (post) asio::post(ws_.get_executor(), [self = shared_from_this()] { self->drain_inbox(); });
+}
+
+void GwSession::drain_inbox() {
+  {
+    std::lock_guard<std::mutex> lk(in_mx_);
+    in_posted_ = false;
+  }
+  if (!writing_) start_batch(); // 쓰는 중이면 묶음이 끝날 때 가져감
+}
+
+// WS 쪽이 못 따라옴: 링크 읽기는 다른 클라이언트와 공유라 멈출 수 없으므로 이 클라이언트를 끊음
+// (읽기가 실패하며 finish -> 서버에 Close)
+void GwSession::evict() {
+  if (evicted_.exchange(true)) return;
+  owner_->stats->evicted.fetch_add(1, std::memory_order_relaxed);
+  asio::post(ws_.get_executor(), [self = shared_from_this()] {
+    self->closing_ = true; // 다음 묶음은 시작하지 않음
+    beast::error_code ec;
+    beast::get_lowest_layer(self->ws_).close(ec);
+  });
+}
+
+// 쌓인 프레임을 통째로 가져와 write 한 번 -> 소켓에 다 써진 뒤 다음 묶음
+// 그동안 들어온 것은 inbox 에 쌓여 out_bytes_ 로 잡힘 (-> evict)
+void GwSession::start_batch() {
+  // close 를 보냈거나 받은 뒤에는 데이터 프레임을 쓰지 않음
+  if (done_ || closing_ || !ws_.is_open()) return;
+  {
+    std::lock_guard<std::mutex> lk(in_mx_);
+    if (in_buf_.empty()) return;
+    out_buf_.swap(in_buf_);
+  }
+  writing_ = true;
+  ws_.next_layer().write_raw(asio::buffer(out_buf_), [self = shared_from_this()](beast::error_code) {
+    // 실패하면 읽기 쪽이 곧 실패하며 정리함
+    asio::post(self->ws_.get_executor(), [self] { self->end_batch(); });
+  });
+}
+
+void GwSession::end_batch() {
+  out_bytes_.fetch_sub(out_buf_.size(), std::memory_order_relaxed);
+  out_buf_.clear();
+  writing_ = false;
+  start_batch();
+}
+
+// 서버가 채널을 닫았거나 링크가 끊김: WS 를 닫음 (읽기가 끝나며 finish -> Close 답)
+void GwSession::remote_close() {
+  asio::post(ws_.get_executor(), [self = shared_from_this()] {
+    if (self->done_ || self->closing_) return;
+    self->closing_ = true; // 이미 넘긴 묶음까지만 나가고 다음 묶음은 시작하지 않음
+    // 상대가 close 응답을 주지 않으면(죽은 연결) 오래 붙잡지 않게 잠시 뒤 소켓을 닫음
+    auto guard = std::make_shared<asio::steady_timer>(self->ws_.get_executor(),
+                                                      std::chrono::seconds(1));
+    guard->async_wait([self, guard](beast::error_code ec) {
+      if (ec) return;
+      beast::get_lowest_layer(self->ws_).close(ec);
+    });
+    self->ws_.async_close(websocket::close_code::normal,
+                          [guard](beast::error_code) { guard->cancel(); });
+  });
+}
+
+void GwSession::finish() {
+  if (done_.exchange(true)) return;
+  if (link_) link_->close(ch_);
+}
+
+void GwSession::abort() {
+  beast::error_code ec;
+  ws_.next_layer().close(ec);
+  done_ = true;
+}
+
+// ---- WsGateway ----
+
+WsGateway::WsGateway(std::string tcp_host, int tcp_port, WsGatewayOptions opt)
+    : tcp_host_(std::move(tcp_host)), tcp_port_(tcp_port), opt_(opt) {}
 
 WsGateway::~WsGateway() { stop(); }
 
 bool WsGateway::start(int ws_port) {
   if (running_) return false;
 
-  impl_ = std::make_unique<Impl>(tcp_host_, tcp_port_, &running_);
-  impl_->ws_port = ws_port;
+  impl_ = std::make_unique<Impl>(opt_, &stats_, &running_);
+  Impl& im = *impl_;
+  int n = opt_.io_threads > 0 ? opt_.io_threads
+                              : static_cast<int>(std::thread::hardware_concurrency());
+  if (n <= 0) n = 1;
+  for (int i = 0; i < n; i++) {
+    im.iocs.push_back(std::make_unique<IoContext>(1));
+    im.guards.push_back(asio::make_work_guard(*im.iocs.back()));
+  }
 
   beast::error_code ec;
-  tcp::endpoint ep{tcp::v4(), static_cast<unsigned short>(ws_port)};
-  impl_->acceptor.open(ep.protocol(), ec);
-  if (ec) return false;
-
-  impl_->acceptor.set_option(asio::socket_base::reuse_address(true), ec);
-  if (ec) return false;
+  tcp::resolver resolver(*im.iocs[0]);
+  auto backend = resolver.resolve(tcp_host_, std::to_string(tcp_port_), ec);
+  if (ec || backend.empty()) {
+    std::cerr << "cannot resolve tcp backend " << tcp_host_ << "\n";
+    impl_.reset();
+    return false;
+  }
 
-  impl_->acceptor.bind(ep, ec);
-  if (ec) return false;
+  tcp::endpoint ep{tcp::v4(), static_cast<unsigned short>(ws_port)};
+  im.acceptor = std::make_unique<tcp::acceptor>(*im.iocs[0]);
+  im.accept_backoff = std::make_unique<asio::steady_timer>(*im.iocs[0]);
+  im.acceptor->open(ep.protocol(), ec);
+  if (!ec) im.acceptor->set_option(asio::socket_base::reuse_address(true), ec);
+  if (!ec) im.acceptor->bind(ep, ec);
+  if (!ec) im.acceptor->listen(asio::socket_base::max_listen_connections, ec);
+  if (ec) {
+    impl_.reset();
+    return false;
+  }
 
-  impl_->acceptor.listen(asio::socket_base::max_listen_connections, ec);
-  if (ec) return false;
+  int links = opt_.links > 0 ? opt_.links : 1;
+  for (int i = 0; i < links; i++) {
+    im.links.push_back(std::make_shared<BackendLink>(*im.iocs[i % n], backend.begin()->endpoint(),
+                                                     static_cast<size_t>(i), &im));
+  }
 
   running_ = true;
-  impl_->th = std::thread([this]() { impl_->run_accept_loop(); });
+  for (auto& l : im.links) l->start();
+  im.do_accept();
+  for (auto& ioc : im.iocs) {
+    im.threads.emplace_back([&ioc] { ioc->run(); });
+  }
 
   std::cout << "WS gateway listening on " << ws_port
-            << " (tcp backend " << tcp_host_ << ":" << tcp_port_ << ")\n";
+            << " (tcp backend " << tcp_host_ << ":" << tcp_port_ << ", " << links
+            << " links, " << n << " io threads)\n";
   return true;
 }
 
@@ -158,12 +778,27 @@ void WsGateway::stop() {
   if (!running_) return;
   running_ = false;
 
-  if (impl_) {
-    beast::error_code ec;
-    impl_->acceptor.close(ec);
-    if (impl_->th.joinable()) impl_->th.join();
-    impl_.reset();
+  Impl& im = *impl_;
+  for (auto& ioc : im.iocs) ioc->stop();
+  for (auto& t : im.threads) {
+    if (t.joinable()) t.join();
+  }
+  // 루프가 멈춘 뒤 남은 소켓을 닫음 (백엔드는 링크가 끊기면 채널을 모두 정리)
+  std::vector<std::shared_ptr<GwSession>> live;
+  {
+    std::lock_guard<std::mutex> lk(im.sess_mx);
+    for (auto& [_, w] : im.sessions) {
+      if (auto sp = w.lock()) live.push_back(std::move(sp));
+    }
   }
+  for (auto& s : live) s->abort();
+  live.clear();
+  for (auto& l : im.links) l->stop();
+  beast::error_code ec;
+  im.acceptor->close(ec);
+  im.guards.clear();
+  for (auto& ioc : im.iocs) ioc->drop_handlers();
+  impl_.reset();
 }
 
 } // namespace transport::gateway
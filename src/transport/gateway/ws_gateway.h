@@ -1,22 +1,59 @@
 #pragma once
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <thread>
 #include <string>
 
 namespace transport::gateway {
 
+class BackendLink;
+class GwSession;
+
+struct WsGatewayOptions {
+  int links = 4;      // 백엔드(chatd_tcp --mux-port) 링크 수
+  int io_threads = 0; // WS 세션 + 링크가 나눠 쓰는 io_context 수 (0 = 코어 수)
+  // 클라이언트별 링크 송신 대기 상한: 넘으면 그 클라이언트의 WS 읽기를 멈췄다가 절반 아래로 줄면 재개
+  size_t backend_max_bytes = 256 * 1024;
+  // 클라이언트별 WS 송신 대기 상한: 넘으면 그 클라이언트를 끊음 (링크 읽기는 모두가 공유하므로 멈추지 않음)
+  size_t client_max_bytes = 4 * 1024 * 1024;
+};
+
+struct WsGatewayStats {
+  std::atomic<uint64_t> to_backend{0};  // WS -> TCP 중계 메시지
+  std::atomic<uint64_t> to_clients{0};  // TCP -> WS 중계 메시지
+  std::atomic<uint64_t> read_pauses{0}; // backend_max_bytes 때문에 WS 읽기를 멈춘 횟수
+  std::atomic<uint64_t> evicted{0};     // client_max_bytes 를 넘어 끊은 클라이언트
+};
+
+// WS 클라이언트 <-> chatd_tcp 중계
+// - WS 쪽은 io_context 풀 위의 비동기 세션 (클라이언트당 스레드 없음)
+// - 백엔드 쪽은 고정된 수의 다중화 링크 (common/mux_frame.h). 클라이언트 하나 = 채널 하나
+//   새 클라이언트는 살아 있는 링크에 라운드로빈으로 붙음. 링크가 끊기면 그 위의 클라이언트를
+//   닫고 링크는 1초 간격으로 다시 연결
+// - 중계 복사는 방향마다 최대 1번
+//   WS -> TCP: 읽은 flat_buffer 를 통째로 링크 큐로 넘기고 헤더와 함께 gather write (복사 0)
+//   TCP -> WS: 링크 디코더 버퍼에서 클라이언트 송신 큐로 1번
+// - WS 프레임을 직접 써서 내보내므로 permessage-deflate 는 협상하지 않음 (압축 없음)
 class WsGateway {
 public:
-  WsGateway(std::string tcp_host, int tcp_port);
+  WsGateway(std::string tcp_host, int tcp_port, WsGatewayOptions opt = {});
   ~WsGateway();
 
   bool start(int ws_port);
   void stop();
 
+  const WsGatewayStats& stats() const { return stats_; }
+
 private:
+  friend class BackendLink;
+  friend class GwSession;
+
   std::string tcp_host_;
   int tcp_port_;
+  WsGatewayOptions opt_;
+  WsGatewayStats stats_;
 
   std::atomic<bool> running_{false};
 
@@ -0,0 +1,384 @@
+#include "transport/tcp/mux_server.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/frame_decoder.h"
+#include "common/mux_frame.h"
+#include "net/net_platform.h"
+
+namespace transport::tcp {
+
+namespace {
+// 송신 스레드가 채널 하나에서 한 번에 꺼내는 프레임 수 / 한 번의 writev 에 담는 프레임 수
+constexpr size_t kChannelBurst = 16;
+constexpr size_t kWriteFrames = 256;
+}
+
+class MuxChannel;
+
+struct MuxServer::Impl {
+  std::shared_ptr<core::ChatCore> core;
+  const MuxServerOptions* opt = nullptr;
+  core::OutboundStats* out_stats = nullptr;
+  std::atomic<bool>* running = nullptr;
+
+  net::socket_t listen_sock = net::INVALID_SOCKET_FD;
+  std::thread accept_th;
+
+  mutable std::mutex links_mx;
+  std::condition_variable links_cv;
+  std::unordered_map<uint64_t, std::shared_ptr<MuxLink>> links; // 종료 시 정리용
+
+  void accept_loop();
+};
+
+// 게이트웨이 연결 하나. 수신 스레드가 채널 테이블을 소유 (on_connect/on_frame/on_disconnect
+// 가 모두 이 스레드에서 불림), 송신 스레드는 준비된 채널의 큐를 비움
+class MuxLink : public std::enable_shared_from_this<MuxLink> {
+public:
+  MuxLink(net::socket_t s, uint64_t seq, MuxServer::Impl* owner)
+      : sock_(s), seq_(seq), owner_(owner) {}
+
+  ~MuxLink() {
+    if (sock_ != net::INVALID_SOCKET_FD) net::close_socket(sock_);
+  }
+
+  void run(); // 수신 스레드 본체 (끝나면 owner 목록에서 빠짐)
+  void shutdown() { net::shutdown_socket(sock_); }
+
+  bool push(const std::shared_ptr<MuxChannel>& ch, core::FramePtr f, core::MsgClass cls);
+  void close_channel(MuxChannel* ch);
+
+private:
+  void handle_control(std::string_view payload);
+  void write_loop();
+
+  net::socket_t sock_;
+  uint64_t seq_;
+  MuxServer::Impl* owner_;
+
+  // 수신 스레드 전용
+  std::unordered_map<uint32_t, std::shared_ptr<MuxChannel>> chans_;
+
+  // 아래는 mx_ 로 보호 (채널의 큐/플래그 포함)
+  std::mutex mx_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::deque<std::shared_ptr<MuxChannel>> ready_; // 보낼 프레임이 있는 채널 (라운드로빈)
+  std::vector<std::string> ctrl_;                 // 보낼 컨트롤 프레임 (Close)
+};
+
+class MuxChannel : public core::Connection, public std::enable_shared_from_this<MuxChannel> {
+public:
+  MuxChannel(std::shared_ptr<MuxLink> link, uint32_t ch, std::string id,
+             const core::OutboundLimits* limits, core::OutboundStats* stats)
+      : link_(std::move(link)), ch_(ch), id_(std::move(id)), q_(limits, stats) {}
+
+  using core::Connection::enqueue;
+
+  bool send(const nlohmann::json& j) override {
+    return enqueue(j, core::MsgClass::System);
+  }
+
+  bool enqueue(const core::FramePtr& frame, core::MsgClass cls) override {
+    core::FramePtr f = core::Frame::as(frame, encoding());
+    if (f->payload_size() > framing::kMaxFrameSize) return false;
+    return link_->push(shared_from_this(), std::move(f), cls);
+  }
+
+  // 게이트웨이에 Close 를 보내고 답을 기다림 (정리는 답을 받은 수신 스레드가)
+  void close() override { link_->close_channel(this); }
+
+  std::string id() const override { return id_; }
+
+  uint32_t channel() const { return ch_; }
+  bool closed() const { return closed_.load(std::memory_order_relaxed); }
+
+private:
+  friend class MuxLink;
+
+  std::shared_ptr<MuxLink> link_;
+  uint32_t ch_;
+  std::string id_;
+  std::atomic<bool> closed_{false};
+
+  // 링크 mx_ 안에서만
+  core::OutboundQueue q_;
+  bool ready_ = false;
+};
+
+bool MuxLink::push(const std::shared_ptr<MuxChannel>& ch, core::FramePtr f, core::MsgClass cls) {
+  std::lock_guard<std::mutex> lk(mx_);
+  if (stop_ || ch->closed()) return false;
+  switch (ch->q_.push(std::move(f), cls)) {
+    case core::OutboundQueue::Push::Overflow:
+      return false; // 정책상 끊음 -> core 가 close()
+    case core::OutboundQueue::Push::Dropped:
+      return true;
+    case core::OutboundQueue::Push::Queued:
+      break;
+  }
+  if (!ch->ready_) {
+    ch->ready_ = true;
+    ready_.push_back(ch);
+    if (ready_.size() == 1) cv_.notify_one();
+  }
+  return true;
+}
+
+void MuxLink::close_channel(MuxChannel* ch) {
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (ch->closed_.exchange(true)) return;
+    ch->q_.clear();
+    if (stop_) return;
+    ctrl_.push_back(mux::control(mux::Op::Close, ch->ch_));
+  }
+  cv_.notify_one();
+}
+
+void MuxLink::write_loop() {
+  std::vector<std::string> ctrl;
+  std::deque<core::OutboundQueue::Item> taken;
+  std::vector<std::pair<uint32_t, core::FramePtr>> frames;
+  std::vector<uint8_t> heads;
+  std::vector<net::IoSlice> slices;
+
+  std::unique_lock<std::mutex> lk(mx_);
+  while (true) {
+    cv_.wait(lk, [this] { return stop_ || !ready_.empty() || !ctrl_.empty(); });
+    if (stop_) break;
+
+    ctrl.swap(ctrl_);
+    // 준비된 채널을 돌며 몇 프레임씩. 남은 게 있으면 줄 뒤로 (다음 writev 에서 이어서)
+    size_t rounds = ready_.size();
+    while (rounds-- > 0 && frames.size() < kWriteFrames) {
+      std::shared_ptr<MuxChannel> ch = std::move(ready_.front());
+      ready_.pop_front();
+      ch->q_.take(taken, kChannelBurst);
+      for (auto& it : taken) frames.emplace_back(ch->ch_, std::move(it.frame));
+      taken.clear();
+      if (ch->q_.empty()) ch->ready_ = false;
+      else ready_.push_back(std::move(ch));
+    }
+    lk.unlock();
+
+    heads.resize(frames.size() * mux::kChannelBytes);
+    slices.clear();
+    for (auto& c : ctrl) {
+      slices.push_back({reinterpret_cast<const uint8_t*>(c.data()), c.size()});
+    }
+    for (size_t i = 0; i < frames.size(); i++) {
+      uint8_t* h = heads.data() + i * mux::kChannelBytes;
+      mux::put_u32(h, frames[i].first);
+      std::string_view b = frames[i].second->tcp_bytes();
+      slices.push_back({h, mux::kChannelBytes});
+      slices.push_back({reinterpret_cast<const uint8_t*>(b.data()), b.size()});
+    }
+    bool ok = net::send_all_v(sock_, slices.data(), slices.size());
+    ctrl.clear();
+    frames.clear();
+
+    lk.lock();
+    if (!ok) {
+      // 수신 스레드가 깨어나 채널을 모두 정리함
+      net::shutdown_socket(sock_);
+      break;
+    }
+  }
+}
+
+void MuxLink::handle_control(std::string_view payload) {
+  mux::Op op;
+  uint32_t ch = 0;
+  std::string_view info;
+  if (!mux::parse_control(payload, op, ch, info)) return;
+
+  if (op == mux::Op::Open) {
+    if (chans_.count(ch)) return;
+    std::ostringstream oss;
+    oss << "mux:" << seq_ << ":" << ch;
+    auto c = std::make_shared<MuxChannel>(shared_from_this(), ch, oss.str(),
+                                          &owner_->opt->outbound, owner_->out_stats);
+    chans_.emplace(ch, c);
+    owner_->core->on_connect(c);
+    return;
+  }
+
+  if (op == mux::Op::Close) {
+    auto it = chans_.find(ch);
+    if (it == chans_.end()) return;
+    std::shared_ptr<MuxChannel> c = std::move(it->second);
+    chans_.erase(it);
+    {
+      std::lock_guard<std::mutex> lk(mx_);
+      c->closed_ = true;
+      c->q_.clear();
+    }
+    owner_->core->on_disconnect(c);
+  }
+}
+
+void MuxLink::run() {
+  std::thread writer([this] { write_loop(); });
+
+  framing::FrameDecoder decoder(256 * 1024, framing::kMaxFrameSize, mux::kChannelBytes);
+  bool alive = true;
+  while (alive && decoder.read_some(sock_) == framing::FrameDecoder::ReadResult::Ok) {
+    std::string_view payload;
+    uint32_t ch = 0;
+    while (decoder.next(payload, &ch)) {
+      if (ch == mux::kControl) {
+        handle_control(payload);
+        continue;
+      }
+      auto it = chans_.find(ch);
+      if (it == chans_.end() || it->second->closed()) continue;
+      // 잘못된 프레임: TCP 연결처럼 그 채널만 끊음
+      if (!owner_->core->on_frame(it->second, payload)) it->second->close();
+    }
+    if (decoder.error()) alive = false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mx_);
+    stop_ = true;
+    for (auto& c : ready_) c->ready_ = false;
+    ready_.clear();
+    ctrl_.clear();
+  }
+  cv_.notify_one();
+  writer.join();
+  net::shutdown_socket(sock_);
+
+  // 링크가 끊기면 그 위의 채널은 모두 끊긴 것
+  for (auto& [_, c] : chans_) {
+    c->closed_ = true;
+    owner_->core->on_disconnect(c);
+  }
+  chans_.clear(); // 채널 -> 링크 참조 순환도 여기서 끊김
+
+  std::lock_guard<std::mutex> lk(owner_->links_mx);
+  owner_->links.erase(seq_);
+  owner_->links_cv.notify_all();
+}
+
+void MuxServer::Impl::accept_loop() {
+  uint64_t seq = 0;
+  while (running->load()) {
+    sockaddr_in caddr{};
+#ifdef _WIN32
+    int clen = sizeof(caddr);
+#else
+    socklen_t clen = sizeof(caddr);
+#endif
+    net::socket_t cs = ::accept(listen_sock, reinterpret_cast<sockaddr*>(&caddr), &clen);
+    if (!running->load()) {
+      if (cs != net::INVALID_SOCKET_FD) net::close_socket(cs);
+      break;
+    }
+    if (cs == net::INVALID_SOCKET_FD) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      continue;
+    }
+
+    net::set_nodelay(cs); // 링크 하나에 여러 클라이언트의 작은 프레임이 섞여 지나감
+    auto link = std::make_shared<MuxLink>(cs, ++seq, this);
+    {
+      std::lock_guard<std::mutex> lk(links_mx);
+      links.emplace(seq, link);
+    }
+    std::thread([link] { link->run(); }).detach();
+  }
+}
+
+MuxServer::MuxServer(std::shared_ptr<core::ChatCore> core, MuxServerOptions opt)
+    : core_(std::move(core)), opt_(opt) {}
+
+MuxServer::~MuxServer() { stop(); }
+
+size_t MuxServer::links() const {
+  if (!impl_) return 0;
+  std::lock_guard<std::mutex> lk(impl_->links_mx);
+  return impl_->links.size();
+}
+
+bool MuxServer::start(int port) {
+  if (running_) return false;
+  if (!core_) return false;
+
+  if (!net::init()) {
+    std::cerr << "net init failed: " << net::last_error_string() << "\n";
+    return false;
+  }
+
+  net::socket_t s = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (s == net::INVALID_SOCKET_FD) {
+    std::cerr << "socket() failed: " << net::last_error_string() << "\n";
+    net::cleanup();
+    return false;
+  }
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+
+  int one = 1;
+#ifdef _WIN32
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&one, sizeof(one));
+#else
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+#endif
+
+  int backlog = opt_.backlog > 0 ? opt_.backlog : SOMAXCONN;
+  if (::bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(s, backlog) != 0) {
+    std::cerr << "mux listen failed: " << net::last_error_string() << "\n";
+    net::close_socket(s);
+    net::cleanup();
+    return false;
+  }
+
+  impl_ = std::make_unique<Impl>();
+  impl_->core = core_;
+  impl_->opt = &opt_;
+  impl_->out_stats = &out_stats_;
+  impl_->running = &running_;
+  impl_->listen_sock = s;
+
+  running_ = true;
+  impl_->accept_th = std::thread([this] { impl_->accept_loop(); });
+  std::cout << "mux listening on " << port << "\n";
+  return true;
+}
+
+void MuxServer::stop() {
+  if (!running_) return;
+  running_ = false;
+
+  Impl& im = *impl_;
+  // 막혀 있는 accept 를 깨움 (Linux 는 close 만으로는 깨지 않음)
+  net::shutdown_socket(im.listen_sock);
+  if (im.accept_th.joinable()) im.accept_th.join();
+  net::close_socket(im.listen_sock);
+
+  // 링크를 모두 끊고 수신 스레드가 채널 정리를 마칠 때까지 기다림
+  std::unique_lock<std::mutex> lk(im.links_mx);
+  for (auto& [_, l] : im.links) l->shutdown();
+  im.links_cv.wait(lk, [&] { return im.links.empty(); });
+  lk.unlock();
+
+  impl_.reset();
+  net::cleanup();
+}
+
+} // namespace transport::tcp
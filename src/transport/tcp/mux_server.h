@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "core/chat_core.h"
+#include "core/outbound_queue.h"
+
+namespace transport::tcp {
+
+class MuxLink;
+
+struct MuxServerOptions {
+  int backlog = 16;              // listen() backlog (0 이하 = SOMAXCONN)
+  core::OutboundLimits outbound; // 채널별 송신 큐 상한 / 느린 소비자 정책
+};
+
+// 게이트웨이용 다중화 리스너 (포맷: common/mux_frame.h)
+// - 링크(게이트웨이의 백엔드 TCP 연결) 하나에 WS 클라이언트 여러 명이 채널로 실림
+// - 채널마다 core::Connection 하나. core 입장에서는 보통 연결과 같음
+// - 링크마다 수신 스레드 + 송신 스레드 (링크는 게이트웨이당 몇 개뿐)
+//   송신: 채널별 OutboundQueue 에 쌓고, 송신 스레드가 준비된 채널을 돌아가며 몇 프레임씩
+//   꺼내 writev 한 번으로 보냄 (한 채널이 링크를 독점하지 않게)
+// - TcpServer 모드와 상관없이 따로 뜸 (chatd_tcp --mux-port)
+class MuxServer {
+public:
+  explicit MuxServer(std::shared_ptr<core::ChatCore> core, MuxServerOptions opt = {});
+  ~MuxServer();
+
+  bool start(int port);
+  void stop();
+
+  const core::OutboundStats& outbound_stats() const { return out_stats_; }
+  size_t links() const;
+
+private:
+  friend class MuxLink;
+  struct Impl;
+
+  std::shared_ptr<core::ChatCore> core_;
+  MuxServerOptions opt_;
+  core::OutboundStats out_stats_;
+  std::atomic<bool> running_{false};
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace transport::tcp
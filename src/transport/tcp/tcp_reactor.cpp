@@ -0,0 +1,509 @@
+#include "transport/tcp/tcp_reactor.h"
+
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/uio.h>
+#endif
+
+#include "common/frame_decoder.h"
+#include "common/json_io.h"
+
+using jsonio::json;
+
+namespace transport::tcp {
+
+#ifdef __linux__
+
+namespace {
+
+constexpr uint32_t kMaxFrame = framing::kMaxFrameSize;
+constexpr int kMaxEvents = 256;
+
+constexpr size_t kMaxIov = 128;
+
+// fd 고갈(EMFILE 등)로 accept 가 실패했을 때 다시 시도할 간격
+constexpr long kAcceptRetryNs = 100L * 1000 * 1000;
+
+class ReactorConnection;
+
+// loop 당 1개. 보낼 프레임이 쌓인 연결을 모았다가 loop 스레드가 한꺼번에 flush
+// - cork_us == 0: 현재 이벤트 배치 처리가 끝나면 flush (배치 중 생긴 프레임끼리 합쳐짐)
+// - cork_us  > 0: 첫 프레임이 쌓이고 cork_us 가 지나면 flush (timerfd)
+struct FlushQueue {
+  std::mutex mx;
+  std::vector<std::shared_ptr<ReactorConnection>> list;
+  int wakefd = -1;
+  int timerfd = -1;
+  unsigned cork_us = 0;
+  std::thread::id loop_tid;
+
+  void push(std::shared_ptr<ReactorConnection> c) {
+    bool was_empty = false;
+    {
+      std::lock_guard<std::mutex> lk(mx);
+      was_empty = list.empty();
+      list.push_back(std::move(c));
+    }
+    if (!was_empty) return;
+
+    if (cork_us > 0) {
+      itimerspec ts{};
+      ts.it_value.tv_sec = cork_us / 1000000;
+      ts.it_value.tv_nsec = static_cast<long>(cork_us % 1000000) * 1000;
+      ::timerfd_settime(timerfd, 0, &ts, nullptr);
+    } else if (std::this_thread::get_id() != loop_tid) {
+      uint64_t one = 1;
+      (void)!::write(wakefd, &one, sizeof(one));
+    }
+  }
+
+  void take(std::vector<std::shared_ptr<ReactorConnection>>& out) {
+    std::lock_guard<std::mutex> lk(mx);
+    out.swap(list);
+  }
+};
+
+// reactor 모드 연결
+// - send(): 어느 스레드에서 호출돼도 안전. 프레임을 큐에 넣기만 하고 소켓은 건드리지 않음
+//           flush 는 소유 loop 가 writev(sendmsg) 로 여러 프레임을 한 번에 내보냄
+//           (프레임은 브로드캐스트 수신자끼리 공유, 다 못 쓰면 EPOLLOUT 엣지에서 이어서 flush)
+// - close(): fd 를 직접 닫지 않고 shutdown 만 함. 실제 close 는 소유 loop 가 담당
+//           (다른 스레드에서 닫으면 fd 번호 재사용 레이스가 생김)
+class ReactorConnection : public core::Connection {
+public:
+  ReactorConnection(int fd, std::string id, FlushQueue* fq,
+                    const core::OutboundLimits* limits, core::OutboundStats* stats)
+    : fd_(fd), id_(std::move(id)), fq_(fq), out_(limits, stats) {}
+
+  using core::Connection::enqueue;
+
+  bool send(const json& j) override {
+    return enqueue(j, core::MsgClass::System);
+  }
+
+  // 느린 소비자 정책은 OutboundQueue 가 적용. Overflow 면 연결 종료
+  bool enqueue(const core::FramePtr& frame, core::MsgClass cls) override {
+    core::FramePtr f = core::Frame::as(frame, encoding());
+    if (core::Compression* z = compression()) f = core::Frame::compressed(f, *z);
+    if (f->payload_size() > kMaxFrame) return false;
+
+    bool schedule = false;
+    {
+      std::lock_guard<std::mutex> lk(out_mx_);
+      if (fd_ < 0 || closed_.load()) return false;
+      auto r = out_.push(std::move(f), cls);
+      if (r == core::OutboundQueue::Push::Overflow) {
+        closed_ = true;
+        ::shutdown(fd_, SHUT_RDWR);
+        return false;
+      }
+      if (r == core::OutboundQueue::Push::Queued && !flush_scheduled_) {
+        flush_scheduled_ = true;
+        schedule = true;
+      }
+    }
+    if (schedule) {
+      if (auto self = self_.lock()) fq_->push(std::move(self));
+    }
+    return true;
+  }
+
+  void close() override {
+    if (closed_.exchange(true)) return;
+    std::lock_guard<std::mutex> lk(out_mx_);
+    if (fd_ >= 0) ::shutdown(fd_, SHUT_RDWR);
+  }
+
+  std::string id() const override { return id_; }
+  bool can_compress() const override { return true; }
+
+  // loop 스레드 전용
+  bool flush() {
+    std::lock_guard<std::mutex> lk(out_mx_);
+    flush_scheduled_ = false;
+    if (fd_ < 0) return false;
+    return flush_locked_();
+  }
+
+  // loop 스레드 전용: fd 를 실제로 닫음 (이후 send 는 전부 실패)
+  void release() {
+    closed_ = true;
+    std::lock_guard<std::mutex> lk(out_mx_);
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    out_.clear();
+  }
+
+  bool closed() const { return closed_.load(); }
+
+  framing::FrameDecoder decoder_; // 수신 버퍼 (loop 스레드 전용)
+  std::weak_ptr<ReactorConnection> self_;
+
+private:
+  bool flush_locked_() {
+    while (!out_.empty()) {
+      iovec iov[kMaxIov];
+      size_t cnt = 0;
+      size_t skip = out_.head_off(); // 맨 앞 프레임에서 이미 보낸 바이트
+      // 공유 프레임 버퍼를 그대로 iovec 으로 (프레임당 1개, 복사 없음)
+      auto& items = out_.items();
+      for (auto it = items.begin(); it != items.end() && cnt < kMaxIov; ++it) {
+        std::string_view b = it->frame->tcp_bytes();
+        iov[cnt].iov_base = const_cast<char*>(b.data() + skip);
+        iov[cnt].iov_len = b.size() - skip;
+        cnt++;
+        skip = 0;
+      }
+
+      msghdr mh{};
+      mh.msg_iov = iov;
+      mh.msg_iovlen = cnt;
+      ssize_t n = ::sendmsg(fd_, &mh, MSG_NOSIGNAL | MSG_DONTWAIT);
+      if (n < 0 && errno == EINTR) continue;
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+      if (n <= 0) {
+        ::shutdown(fd_, SHUT_RDWR);
+        return false;
+      }
+
+      // 다 보낸 프레임은 큐에서 제거
+      out_.consume(static_cast<size_t>(n));
+    }
+    return true;
+  }
+
+  int fd_;
+  std::string id_;
+  FlushQueue* fq_;
+  std::atomic<bool> closed_{false};
+
+  std::mutex out_mx_;
+  core::OutboundQueue out_;
+  bool flush_scheduled_ = false;
+};
+
+void pin_thread(std::thread& th, int cpu) {
+  int ncpu = static_cast<int>(std::thread::hardware_concurrency());
+  if (ncpu <= 0) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % ncpu, &set);
+  if (pthread_setaffinity_np(th.native_handle(), sizeof(set), &set) != 0) {
+    std::cerr << "pthread_setaffinity_np failed (cpu " << cpu % ncpu << ")\n";
+  }
+}
+
+bool set_nonblocking(int fd) {
+  int fl = ::fcntl(fd, F_GETFL, 0);
+  if (fl < 0) return false;
+  return ::fcntl(fd, F_SETFL, fl | O_NONBLOCK) == 0;
+}
+
+} // namespace
+
+struct ReactorPool::Loop {
+  int epfd = -1;
+  int wakefd = -1;
+  int accept_timerfd = -1; // 0번 loop 만: accept 재시도 타이머
+  std::thread th;
+
+  // accept 한 loop 가 다른 loop 로 넘겨주는 fd 목록
+  std::mutex pending_mx;
+  std::vector<int> pending;
+
+  std::unordered_map<int, std::shared_ptr<ReactorConnection>> conns;
+
+  FlushQueue flushq;
+};
+
+ReactorPool::ReactorPool(std::shared_ptr<core::ChatCore> core, int io_threads)
+  : core_(std::move(core)), io_threads_(io_threads > 0 ? io_threads : 1) {}
+
+ReactorPool::~ReactorPool() {
+  stop();
+}
+
+bool ReactorPool::supported() {
+  return true;
+}
+
+bool ReactorPool::start(net::socket_t listen_sock) {
+  if (running_) return false;
+  if (!set_nonblocking(listen_sock)) return false;
+  listen_sock_ = listen_sock;
+
+  for (int i = 0; i < io_threads_; i++) {
+    auto lp = std::make_unique<Loop>();
+    lp->epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    lp->wakefd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    lp->flushq.timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (lp->epfd < 0 || lp->wakefd < 0 || lp->flushq.timerfd < 0) {
+      std::cerr << "epoll/eventfd/timerfd failed: " << net::last_error_string() << "\n";
+      if (lp->epfd >= 0) ::close(lp->epfd);
+      if (lp->wakefd >= 0) ::close(lp->wakefd);
+      if (lp->flushq.timerfd >= 0) ::close(lp->flushq.timerfd);
+      for (auto& o : loops_) {
+        ::close(o->epfd);
+        ::close(o->wakefd);
+        ::close(o->flushq.timerfd);
+      }
+      loops_.clear();
+      return false;
+    }
+    lp->flushq.wakefd = lp->wakefd;
+    lp->flushq.cork_us = cork_us_;
+    for (int fd : {lp->wakefd, lp->flushq.timerfd}) {
+      epoll_event ev{};
+      ev.events = EPOLLIN;
+      ev.data.fd = fd;
+      ::epoll_ctl(lp->epfd, EPOLL_CTL_ADD, fd, &ev);
+    }
+    loops_.push_back(std::move(lp));
+  }
+
+  // listener 는 0번 loop 가 담당
+  // edge-triggered 라 accept 가 EAGAIN 말고 다른 이유로 멈추면 새 엣지가 오지 않음
+  // -> 재시도 타이머로 다시 깨움
+  Loop& l0 = *loops_[0];
+  l0.accept_timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLET;
+  ev.data.fd = listen_sock_;
+  bool ok = l0.accept_timerfd >= 0 &&
+            ::epoll_ctl(l0.epfd, EPOLL_CTL_ADD, listen_sock_, &ev) == 0;
+  if (ok) {
+    epoll_event tev{};
+    tev.events = EPOLLIN;
+    tev.data.fd = l0.accept_timerfd;
+    ok = ::epoll_ctl(l0.epfd, EPOLL_CTL_ADD, l0.accept_timerfd, &tev) == 0;
+  }
+  if (!ok) {
+    std::cerr << "epoll_ctl(listen) failed: " << net::last_error_string() << "\n";
+    if (l0.accept_timerfd >= 0) ::close(l0.accept_timerfd);
+    for (auto& lp : loops_) {
+      ::close(lp->epfd);
+      ::close(lp->wakefd);
+      ::close(lp->flushq.timerfd);
+    }
+    loops_.clear();
+    return false;
+  }
+
+  running_ = true;
+  for (size_t i = 0; i < loops_.size(); i++) {
+    Loop* p = loops_[i].get();
+    p->th = std::thread([this, p]() { run_loop_(*p); });
+    if (first_cpu_ >= 0) pin_thread(p->th, first_cpu_ + static_cast<int>(i));
+  }
+  return true;
+}
+
+void ReactorPool::stop() {
+  if (!running_) return;
+  running_ = false;
+
+  for (auto& lp : loops_) {
+    uint64_t one = 1;
+    (void)!::write(lp->wakefd, &one, sizeof(one));
+  }
+  for (auto& lp : loops_) {
+    if (lp->th.joinable()) lp->th.join();
+  }
+  for (auto& lp : loops_) {
+    std::vector<int> fds;
+    for (auto& [fd, _] : lp->conns) fds.push_back(fd);
+    for (int fd : fds) drop_(*lp, fd);
+    for (int fd : lp->pending) ::close(fd);
+    lp->pending.clear();
+    ::close(lp->epfd);
+    ::close(lp->wakefd);
+    ::close(lp->flushq.timerfd);
+    if (lp->accept_timerfd >= 0) ::close(lp->accept_timerfd);
+  }
+  loops_.clear();
+  listen_sock_ = net::INVALID_SOCKET_FD;
+}
+
+void ReactorPool::run_loop_(Loop& lp) {
+  lp.flushq.loop_tid = std::this_thread::get_id();
+  epoll_event events[kMaxEvents];
+  while (running_) {
+    int n = ::epoll_wait(lp.epfd, events, kMaxEvents, -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      std::cerr << "epoll_wait failed: " << net::last_error_string() << "\n";
+      break;
+    }
+    for (int i = 0; i < n && running_; i++) {
+      int fd = events[i].data.fd;
+      uint32_t ev = events[i].events;
+
+      if (fd == lp.wakefd) {
+        uint64_t v = 0;
+        while (::read(lp.wakefd, &v, sizeof(v)) > 0) {}
+        adopt_pending_(lp);
+        continue;
+      }
+      if (fd == lp.flushq.timerfd) {
+        uint64_t v = 0;
+        while (::read(lp.flushq.timerfd, &v, sizeof(v)) > 0) {}
+        flush_pending_(lp);
+        continue;
+      }
+      if (fd == listen_sock_) {
+        on_accept_ready_();
+        continue;
+      }
+      if (fd == lp.accept_timerfd) {
+        uint64_t v = 0;
+        while (::read(lp.accept_timerfd, &v, sizeof(v)) > 0) {}
+        on_accept_ready_();
+        continue;
+      }
+
+      if (ev & EPOLLOUT) on_writable_(lp, fd);
+      if (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) on_readable_(lp, fd);
+    }
+
+    // 이번 배치에서 쌓인 프레임을 연결마다 writev 한 번으로 내보냄
+    if (lp.flushq.cork_us == 0) flush_pending_(lp);
+  }
+}
+
+void ReactorPool::flush_pending_(Loop& lp) {
+  std::vector<std::shared_ptr<ReactorConnection>> list;
+  lp.flushq.take(list);
+  for (auto& c : list) {
+    // 실패하면 shutdown 된 상태 -> EPOLLHUP 으로 drop_ 됨
+    (void)c->flush();
+  }
+}
+
+void ReactorPool::on_accept_ready_() {
+  // edge-triggered 이므로 EAGAIN 이 날 때까지 모두 accept
+  while (running_) {
+    int cs = ::accept4(listen_sock_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (cs < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      // EMFILE/ENFILE/ENOBUFS 등: backlog 에 남은 연결은 새 엣지를 못 받으므로 잠시 뒤 재시도
+      itimerspec ts{};
+      ts.it_value.tv_nsec = kAcceptRetryNs;
+      ::timerfd_settime(loops_[0]->accept_timerfd, 0, &ts, nullptr);
+      break;
+    }
+    Loop& target = *loops_[next_loop_++ % loops_.size()];
+    {
+      std::lock_guard<std::mutex> lk(target.pending_mx);
+      target.pending.push_back(cs);
+    }
+    uint64_t one = 1;
+    (void)!::write(target.wakefd, &one, sizeof(one));
+  }
+}
+
+void ReactorPool::adopt_pending_(Loop& lp) {
+  std::vector<int> fds;
+  {
+    std::lock_guard<std::mutex> lk(lp.pending_mx);
+    fds.swap(lp.pending);
+  }
+  for (int fd : fds) {
+    std::ostringstream oss;
+    oss << "tcp:" << static_cast<std::uintptr_t>(fd);
+    auto conn = std::make_shared<ReactorConnection>(fd, oss.str(), &lp.flushq,
+                                                    &limits_, stats_);
+    conn->self_ = conn;
+
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = fd;
+    if (::epoll_ctl(lp.epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+      ::close(fd);
+      continue;
+    }
+    lp.conns[fd] = conn;
+    core_->on_connect(conn);
+  }
+}
+
+void ReactorPool::on_writable_(Loop& lp, int fd) {
+  auto it = lp.conns.find(fd);
+  if (it == lp.conns.end()) return;
+  if (!it->second->flush()) drop_(lp, fd);
+}
+
+void ReactorPool::on_readable_(Loop& lp, int fd) {
+  auto it = lp.conns.find(fd);
+  if (it == lp.conns.end()) return;
+  auto conn = it->second;
+
+  // edge-triggered: EAGAIN 까지 읽고, 읽을 때마다 완성된 프레임을 바로 디스패치
+  bool eof = false;
+  while (!eof && !conn->closed()) {
+    auto r = conn->decoder_.read_some(fd);
+    if (r == framing::FrameDecoder::ReadResult::WouldBlock) break;
+    if (r != framing::FrameDecoder::ReadResult::Ok) eof = true; // 상대가 닫음/에러
+
+    std::string_view payload;
+    while (!conn->closed() && conn->decoder_.next(payload)) {
+      if (!core_->on_frame(conn, payload)) {
+        // threaded 모드(recv_json 실패 -> 연결 종료)와 동일하게 처리
+        eof = true;
+        break;
+      }
+    }
+    if (conn->decoder_.error()) eof = true;
+  }
+
+  if (eof || conn->closed()) drop_(lp, fd);
+}
+
+void ReactorPool::drop_(Loop& lp, int fd) {
+  auto it = lp.conns.find(fd);
+  if (it == lp.conns.end()) return;
+  auto conn = it->second;
+  lp.conns.erase(it);
+
+  ::epoll_ctl(lp.epfd, EPOLL_CTL_DEL, fd, nullptr);
+  core_->on_disconnect(conn);
+  conn->release();
+}
+
+#else // !__linux__
+
+struct ReactorPool::Loop {};
+
+ReactorPool::ReactorPool(std::shared_ptr<core::ChatCore> core, int io_threads)
+  : core_(std::move(core)), io_threads_(io_threads) {}
+ReactorPool::~ReactorPool() = default;
+bool ReactorPool::supported() { return false; }
+bool ReactorPool::start(net::socket_t) { return false; }
+void ReactorPool::stop() {}
+void ReactorPool::run_loop_(Loop&) {}
+void ReactorPool::on_accept_ready_() {}
+void ReactorPool::adopt_pending_(Loop&) {}
+void ReactorPool::on_readable_(Loop&, int) {}
+void ReactorPool::on_writable_(Loop&, int) {}
+void ReactorPool::drop_(Loop&, int) {}
+void ReactorPool::flush_pending_(Loop&) {}
+
+#endif
+
+} // namespace transport::tcp
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/chat_core.h"
+#include "core/outbound_queue.h"
+#include "net/net_platform.h"
+
+namespace transport::tcp {
+
+// epoll(edge-triggered) 기반 reactor 풀 (Linux 전용)
+// - 고정된 소수의 I/O 스레드가 accept/recv/send 를 모두 처리
+// - 연결당 스레드를 만들지 않으므로 접속자 수와 스레드 수가 무관
+class ReactorPool {
+public:
+  ReactorPool(std::shared_ptr<core::ChatCore> core, int io_threads);
+  ~ReactorPool();
+
+  // listen_sock: 이미 bind/listen 된 소켓 (소유권은 호출자에게 있음)
+  bool start(net::socket_t listen_sock);
+  void stop();
+
+  // start 전에 호출. loop i 를 (first_cpu + i) % 코어수 번 CPU 에 고정
+  void set_cpu_affinity(int first_cpu) { first_cpu_ = first_cpu; }
+
+  // start 전에 호출. 송신 코르크 창(us). 0 이면 이벤트 배치가 끝날 때마다 flush
+  void set_cork_us(unsigned us) { cork_us_ = us; }
+
+  // start 전에 호출. 연결별 송신 큐 상한/정책과 결과 카운터 (stats 는 호출자 소유)
+  void set_outbound(const core::OutboundLimits& limits, core::OutboundStats* stats) {
+    limits_ = limits;
+    stats_ = stats;
+  }
+
+  static bool supported();
+
+private:
+  struct Loop;
+
+  std::shared_ptr<core::ChatCore> core_;
+  int io_threads_;
+  int first_cpu_ = -1;
+  unsigned cork_us_ = 0;
+  core::OutboundLimits limits_;
+  core::OutboundStats own_stats_;
+  core::OutboundStats* stats_ = &own_stats_;
+  std::atomic<bool> running_{false};
+  std::atomic<unsigned> next_loop_{0};
+  net::socket_t listen_sock_{net::INVALID_SOCKET_FD};
+  std::vector<std::unique_ptr<Loop>> loops_;
+
+  void run_loop_(Loop& lp);
+  void on_accept_ready_();
+  void adopt_pending_(Loop& lp);
+  void on_readable_(Loop& lp, int fd);
+  void on_writable_(Loop& lp, int fd);
+  void drop_(Loop& lp, int fd);
+  void flush_pending_(Loop& lp);
+};
+
+} // namespace transport::tcp
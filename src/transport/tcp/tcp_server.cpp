@@ -1,11 +1,14 @@
 #include "transport/tcp/tcp_server.h"
 #include <iostream>
 #include <cstdint>
+#include <mutex>
 #include <thread>
 #include <sstream>
 
 #include "net/net_platform.h"
 #include "common/json_io.h"
+#include "common/frame_decoder.h"
+#include "transport/tcp/tcp_reactor.h"
 
 using jsonio::json;
 
@@ -16,52 +19,58 @@ public:
   TcpConnection(net::socket_t s, std::string id)
     : sock_(s), id_(std::move(id)) {}
 
-  ~TcpConnection() override { close(); }
+  ~TcpConnection() override {
+    if (sock_ != net::INVALID_SOCKET_FD) net::close_socket(sock_);
+  }
+
+  using core::Connection::enqueue;
 
   bool send(const json& j) override {
-    return jsonio::send_json(sock_, j);
+    return enqueue(j, core::MsgClass::System);
+  }
+
+  // threaded 모드는 송신 큐 없이 호출 스레드에서 바로 씀 (공유 프레임 바이트 그대로)
+  bool enqueue(const core::FramePtr& frame, core::MsgClass) override {
+    core::FramePtr f = core::Frame::as(frame, encoding());
+    if (core::Compression* z = compression()) f = core::Frame::compressed(f, *z);
+    std::string_view b = f->tcp_bytes();
+    if (f->payload_size() > framing::kMaxFrameSize) return false;
+    std::lock_guard<std::mutex> lk(write_mx_);
+    if (closed_) return false;
+    return net::send_all(sock_, reinterpret_cast<const uint8_t*>(b.data()), b.size());
   }
 
+  // 다른 스레드(팬아웃/keepalive)에서 불려도 안전하게 shutdown 만: 막힌 recv 가 깨어나
+  // 수신 스레드가 정리하고, fd 는 마지막 참조가 사라질 때 닫음 (그 전엔 재사용되지 않음)
   void close() override {
-    if (closed_) return;
-    closed_ = true;
-    if (sock_ != net::INVALID_SOCKET_FD) {
-      net::close_socket(sock_);
-      sock_ = net::INVALID_SOCKET_FD;
-    }
+    if (closed_.exchange(true)) return;
+    if (sock_ != net::INVALID_SOCKET_FD) net::shutdown_socket(sock_);
   }
 
   std::string id() const override { return id_; }
+  bool can_compress() const override { return true; }
 
   net::socket_t sock() const { return sock_; }
 
 private:
   net::socket_t sock_{net::INVALID_SOCKET_FD};
   std::string id_;
-  bool closed_{false};
+  std::atomic<bool> closed_{false};
+  std::mutex write_mx_;
 };
 
-TcpServer::TcpServer(std::shared_ptr<core::ChatCore> core)
-  : core_(std::move(core)) {}
+TcpServer::TcpServer(std::shared_ptr<core::ChatCore> core, TcpServerOptions opt)
+  : core_(std::move(core)), opt_(opt) {}
 
 TcpServer::~TcpServer() {
   stop();
 }
 
-bool TcpServer::start(int port) {
-  if (running_) return false;
-  if (!core_) return false;
-
-  if (!net::init()) {
-    std::cerr << "net init failed: " << net::last_error_string() << "\n";
-    return false;
-  }
-
-  listen_sock_ = ::socket(AF_INET, SOCK_STREAM, 0);
-  if (listen_sock_ == net::INVALID_SOCKET_FD) {
+net::socket_t TcpServer::open_listener_(int port, bool reuse_port) {
+  net::socket_t s = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (s == net::INVALID_SOCKET_FD) {
     std::cerr << "socket() failed: " << net::last_error_string() << "\n";
-    net::cleanup();
-    return false;
+    return net::INVALID_SOCKET_FD;
   }
 
   sockaddr_in addr{};
@@ -71,37 +80,138 @@ bool TcpServer::start(int port) {
 
   int opt = 1;
 #ifdef _WIN32
-  setsockopt(listen_sock_, SOL_SOCKET, SO_REUSEADDR, (const char*)&opt, sizeof(opt));
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char*)&opt, sizeof(opt));
+#else
+  setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+#endif
+
+#ifdef SO_REUSEPORT
+  if (reuse_port && setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) != 0) {
+    std::cerr << "SO_REUSEPORT failed: " << net::last_error_string() << "\n";
+    net::close_socket(s);
+    return net::INVALID_SOCKET_FD;
+  }
 #else
-  setsockopt(listen_sock_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  (void)reuse_port;
 #endif
 
-  if (::bind(listen_sock_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+  if (::bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
     std::cerr << "bind() failed: " << net::last_error_string() << "\n";
-    net::close_socket(listen_sock_);
-    listen_sock_ = net::INVALID_SOCKET_FD;
-    net::cleanup();
-    return false;
+    net::close_socket(s);
+    return net::INVALID_SOCKET_FD;
   }
 
-  if (::listen(listen_sock_, 16) != 0) {
+  int backlog = opt_.backlog > 0 ? opt_.backlog : SOMAXCONN;
+  if (::listen(s, backlog) != 0) {
     std::cerr << "listen() failed: " << net::last_error_string() << "\n";
-    net::close_socket(listen_sock_);
-    listen_sock_ = net::INVALID_SOCKET_FD;
+    net::close_socket(s);
+    return net::INVALID_SOCKET_FD;
+  }
+  return s;
+}
+
+bool TcpServer::start(int port) {
+  if (running_) return false;
+  if (!core_) return false;
+
+  if (!net::init()) {
+    std::cerr << "net init failed: " << net::last_error_string() << "\n";
+    return false;
+  }
+
+  if (opt_.mode == TcpMode::Sharded) {
+#ifdef SO_REUSEPORT
+    if (!ReactorPool::supported()) opt_.mode = TcpMode::Threaded;
+#else
+    opt_.mode = TcpMode::Threaded;
+#endif
+    if (opt_.mode != TcpMode::Sharded)
+      std::cerr << "sharded mode not supported on this platform, using threaded\n";
+  }
+  if (opt_.mode == TcpMode::Reactor && !ReactorPool::supported()) {
+    std::cerr << "reactor mode not supported on this platform, using threaded\n";
+    opt_.mode = TcpMode::Threaded;
+  }
+
+  int n = opt_.io_threads;
+  if (n <= 0) n = static_cast<int>(std::thread::hardware_concurrency());
+  if (n <= 0) n = 1;
+
+  if (opt_.mode == TcpMode::Sharded) {
+    // reactor N개 = listener N개. 커널이 SO_REUSEPORT 그룹 안에서 새 연결을 분산
+    for (int i = 0; i < n; i++) {
+      net::socket_t ls = open_listener_(port, true);
+      if (ls == net::INVALID_SOCKET_FD) {
+        stop_shards_();
+        net::cleanup();
+        return false;
+      }
+      shard_socks_.push_back(ls);
+
+      auto pool = std::make_unique<ReactorPool>(core_, 1);
+      if (opt_.pin_cpus) pool->set_cpu_affinity(i);
+      pool->set_cork_us(opt_.cork_us);
+      pool->set_outbound(opt_.outbound, &out_stats_);
+      if (!pool->start(ls)) {
+        std::cerr << "reactor start failed\n";
+        stop_shards_();
+        net::cleanup();
+        return false;
+      }
+      shards_.push_back(std::move(pool));
+    }
+    running_ = true;
+    std::cout << "TCP server listening on " << port << " (sharded, " << n << " reactors)\n";
+    return true;
+  }
+
+  listen_sock_ = open_listener_(port, false);
+  if (listen_sock_ == net::INVALID_SOCKET_FD) {
     net::cleanup();
     return false;
   }
 
+  if (opt_.mode == TcpMode::Reactor) {
+    reactor_ = std::make_unique<ReactorPool>(core_, n);
+    if (opt_.pin_cpus) reactor_->set_cpu_affinity(0);
+    reactor_->set_cork_us(opt_.cork_us);
+    reactor_->set_outbound(opt_.outbound, &out_stats_);
+    if (!reactor_->start(listen_sock_)) {
+      std::cerr << "reactor start failed\n";
+      reactor_.reset();
+      net::close_socket(listen_sock_);
+      listen_sock_ = net::INVALID_SOCKET_FD;
+      net::cleanup();
+      return false;
+    }
+    running_ = true;
+    std::cout << "TCP server listening on " << port << " (reactor, " << n << " io threads)\n";
+    return true;
+  }
+
   running_ = true;
   std::thread(&TcpServer::accept_loop_, this).detach();
   std::cout << "TCP server listening on " << port << "\n";
   return true;
 }
 
+void TcpServer::stop_shards_() {
+  for (auto& p : shards_) p->stop();
+  shards_.clear();
+  for (auto s : shard_socks_) net::close_socket(s);
+  shard_socks_.clear();
+}
+
 void TcpServer::stop() {
   if (!running_) return;
   running_ = false;
 
+  if (reactor_) {
+    reactor_->stop();
+    reactor_.reset();
+  }
+  stop_shards_();
+
   if (listen_sock_ != net::INVALID_SOCKET_FD) {
     net::close_socket(listen_sock_);
     listen_sock_ = net::INVALID_SOCKET_FD;
@@ -110,6 +220,7 @@ void TcpServer::stop() {
 }
 
 void TcpServer::accept_loop_() {
+  std::uint64_t accept_seq = 0;
   while (running_) {
     sockaddr_in caddr{};
 #ifdef _WIN32
@@ -121,17 +232,27 @@ void TcpServer::accept_loop_() {
     if (!running_) break;
     if (cs == net::INVALID_SOCKET_FD) continue;
 
-    // id는 간단히 포인터값/카운터도 가능. 여기서는 주소+포트 대신 "tcp:<handle>"
+    // id는 "tcp:<handle>#<seq>" (핸들은 재사용되므로 순번을 붙여 구분)
     std::ostringstream oss;
-    oss << "tcp:" << static_cast<std::uintptr_t>(cs);
+    oss << "tcp:" << static_cast<std::uintptr_t>(cs) << "#" << ++accept_seq;
 
     auto conn = std::make_shared<TcpConnection>(cs, oss.str());
     core_->on_connect(conn);
 
     std::thread([this, conn]() {
-      json j;
-      while (jsonio::recv_json(conn->sock(), j)) {
-        core_->on_message(conn, j);
+      // recv 한 번에 들어온 프레임을 모두 처리 (파이프라이닝 클라이언트 대비)
+      framing::FrameDecoder decoder;
+      bool alive = true;
+      while (alive &&
+             decoder.read_some(conn->sock()) == framing::FrameDecoder::ReadResult::Ok) {
+        std::string_view payload;
+        while (decoder.next(payload)) {
+          if (!core_->on_frame(conn, payload)) {
+            alive = false;
+            break;
+          }
+        }
+        if (decoder.error()) alive = false;
       }
       core_->on_disconnect(conn);
       conn->close();
@@ -1,25 +1,56 @@
 #pragma once
 #include <memory>
 #include <thread>
+#include <vector>
 #include <atomic>
 #include "core/chat_core.h"
+#include "core/outbound_queue.h"
 #include "net/net_platform.h"
 
 namespace transport::tcp {
 
+class ReactorPool;
+
+// Threaded: 연결당 스레드 1개 (블로킹 recv). 송신 큐가 없어 팬아웃 스레드가 바로 send 하므로
+//           수신 창이 찬 클라이언트 하나가 방 전체를 막을 수 있음 (비교용 / reactor 없는 플랫폼용)
+// Reactor : epoll 기반 소수 I/O 스레드가 모든 연결 처리 (Linux 전용, 아니면 Threaded 로 대체)
+// Sharded : reactor N개가 각자 SO_REUSEPORT listener 와 연결 집합을 가짐 (accept 병목 제거)
+enum class TcpMode { Threaded, Reactor, Sharded };
+
+struct TcpServerOptions {
+  TcpMode mode = TcpMode::Reactor; // 연결별 송신 큐가 있는 모드가 기본
+  int io_threads = 0;    // Reactor: I/O 스레드 수, Sharded: reactor 수 (0 = 코어 수)
+  int backlog = 16;      // listen() backlog (0 이하 = SOMAXCONN)
+  bool pin_cpus = false; // reactor 스레드를 코어에 고정
+  unsigned cork_us = 0;  // reactor 송신 코르크 창(us). 이 시간 동안 쌓인 프레임을 writev 한 번으로
+  core::OutboundLimits outbound; // reactor 연결별 송신 큐 상한 / 느린 소비자 정책
+};
+
 class TcpServer {
 public:
-  explicit TcpServer(std::shared_ptr<core::ChatCore> core);
+  explicit TcpServer(std::shared_ptr<core::ChatCore> core, TcpServerOptions opt = {});
   ~TcpServer();
 
   bool start(int port);
   void stop();
 
+  // 송신 큐 결과 카운터 (Reactor/Sharded 모드)
+  const core::OutboundStats& outbound_stats() const { return out_stats_; }
+
 private:
   std::shared_ptr<core::ChatCore> core_;
+  TcpServerOptions opt_;
+  core::OutboundStats out_stats_;
   std::atomic<bool> running_{false};
   net::socket_t listen_sock_{net::INVALID_SOCKET_FD};
+  std::unique_ptr<ReactorPool> reactor_;
+
+  // Sharded 모드
+  std::vector<std::unique_ptr<ReactorPool>> shards_;
+  std::vector<net::socket_t> shard_socks_;
 
+  net::socket_t open_listener_(int port, bool reuse_port);
+  void stop_shards_();
   void accept_loop_();
 };
 
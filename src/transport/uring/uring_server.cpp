@@ -0,0 +1,684 @@
+#include "transport/uring/uring_server.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include "net/net_platform.h"
+#include "common/frame_decoder.h"
+#include "common/json_io.h"
+
+using jsonio::json;
+
+namespace transport::uring {
+
+namespace {
+
+constexpr uint32_t kMaxFrame = framing::kMaxFrameSize;
+constexpr size_t kMaxIov = 128;
+
+// fd 고갈(EMFILE 등)로 accept 가 실패했을 때 다시 걸기까지 기다리는 시간
+constexpr long long kAcceptRetryNs = 100LL * 1000 * 1000;
+
+int sys_setup(unsigned entries, io_uring_params* p) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                                    nullptr, 0));
+}
+
+int sys_register(int fd, unsigned op, const void* arg, unsigned nr) {
+  return static_cast<int>(::syscall(__NR_io_uring_register, fd, op, arg, nr));
+}
+
+// liburing 없이 쓰는 최소 ring 래퍼
+struct Ring {
+  int fd = -1;
+
+  void* sq_ptr = nullptr;
+  size_t sq_sz = 0;
+  void* cq_ptr = nullptr;
+  size_t cq_sz = 0;
+  io_uring_sqe* sqes = nullptr;
+  size_t sqes_sz = 0;
+
+  unsigned* sq_head = nullptr;
+  unsigned* sq_tail = nullptr;
+  unsigned* sq_array = nullptr;
+  unsigned sq_mask = 0;
+  unsigned sq_entries = 0;
+
+  unsigned* cq_head = nullptr;
+  unsigned* cq_tail = nullptr;
+  io_uring_cqe* cqes = nullptr;
+  unsigned cq_mask = 0;
+
+  unsigned local_tail = 0;
+  unsigned pending = 0; // 아직 enter 하지 않은 SQE 수
+
+  bool init(unsigned entries) {
+    io_uring_params p{};
+    fd = sys_setup(entries, &p);
+    if (fd < 0) return false;
+
+    sq_sz = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_sz = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) sq_sz = cq_sz = std::max(sq_sz, cq_sz);
+
+    sq_ptr = ::mmap(nullptr, sq_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd, IORING_OFF_SQ_RING);
+    if (sq_ptr == MAP_FAILED) {
+      sq_ptr = nullptr;
+      destroy();
+      return false;
+    }
+    if (single) {
+      cq_ptr = sq_ptr;
+    } else {
+      cq_ptr = ::mmap(nullptr, cq_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_CQ_RING);
+      if (cq_ptr == MAP_FAILED) {
+        cq_ptr = nullptr;
+        destroy();
+        return false;
+      }
+    }
+    sqes_sz = p.sq_entries * sizeof(io_uring_sqe);
+    void* s = ::mmap(nullptr, sqes_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     fd, IORING_OFF_SQES);
+    if (s == MAP_FAILED) {
+      destroy();
+      return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(s);
+
+    auto* sq = static_cast<char*>(sq_ptr);
+    sq_head = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    sq_mask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    sq_entries = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_entries);
+
+    auto* cq = static_cast<char*>(cq_ptr);
+    cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+    cq_mask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+
+    local_tail = *sq_tail;
+    return true;
+  }
+
+  void destroy() {
+    if (sqes) ::munmap(sqes, sqes_sz);
+    if (cq_ptr && cq_ptr != sq_ptr) ::munmap(cq_ptr, cq_sz);
+    if (sq_ptr) ::munmap(sq_ptr, sq_sz);
+    sqes = nullptr;
+    sq_ptr = cq_ptr = nullptr;
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+  }
+
+  io_uring_sqe* get_sqe() {
+    unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+    if (local_tail - head >= sq_entries) {
+      // SQ 가 꽉 참 -> 지금까지 쌓인 것 먼저 제출
+      submit(0);
+      head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+      if (local_tail - head >= sq_entries) return nullptr;
+    }
+    unsigned idx = local_tail & sq_mask;
+    io_uring_sqe* sqe = &sqes[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array[idx] = idx;
+    local_tail++;
+    pending++;
+    return sqe;
+  }
+
+  // 쌓인 SQE 를 한 번에 제출하고, wait_nr 개 이상 완료될 때까지 대기
+  int submit(unsigned wait_nr) {
+    __atomic_store_n(sq_tail, local_tail, __ATOMIC_RELEASE);
+    unsigned n = pending;
+    pending = 0;
+    for (;;) {
+      int r = sys_enter(fd, n, wait_nr, wait_nr ? IORING_ENTER_GETEVENTS : 0);
+      if (r < 0 && errno == EINTR) {
+        n = 0;
+        continue;
+      }
+      return r;
+    }
+  }
+};
+
+enum Op : uint8_t { OP_ACCEPT = 1, OP_RECV = 2, OP_SEND = 3, OP_WAKE = 4, OP_ACCEPT_RETRY = 5 };
+
+uint64_t pack(Op op, uint32_t slot) {
+  return (static_cast<uint64_t>(slot) << 8) | op;
+}
+
+class UringConnection;
+
+// send 가 쌓인 연결 목록. ring 스레드가 CQE 배치를 처리한 뒤 한꺼번에 SEND 를 건다
+struct DirtyList {
+  std::mutex mx;
+  std::vector<std::shared_ptr<UringConnection>> list;
+  int wake_fd = -1;
+  std::thread::id ring_tid;
+
+  void push(std::shared_ptr<UringConnection> c) {
+    {
+      std::lock_guard<std::mutex> lk(mx);
+      list.push_back(std::move(c));
+    }
+    // ring 스레드 밖(다른 transport 등)에서 호출된 경우에만 깨움
+    if (std::this_thread::get_id() != ring_tid) {
+      uint64_t one = 1;
+      (void)!::write(wake_fd, &one, sizeof(one));
+    }
+  }
+};
+
+class UringConnection : public core::Connection {
+public:
+  UringConnection(int fd, uint32_t slot, std::string id, DirtyList* dirty,
+                  const core::OutboundLimits* limits, core::OutboundStats* stats)
+    : fd_(fd), slot_(slot), id_(std::move(id)), dirty_list_(dirty), out_(limits, stats) {}
+
+  using core::Connection::enqueue;
+
+  bool send(const json& j) override {
+    return enqueue(j, core::MsgClass::System);
+  }
+
+  bool enqueue(const core::FramePtr& f, core::MsgClass cls) override;
+
+  void close() override {
+    if (closed_.exchange(true)) return;
+    ::shutdown(fd_, SHUT_RDWR);
+  }
+
+  std::string id() const override { return id_; }
+  bool can_compress() const override { return true; }
+
+  bool closed() const { return closed_.load(); }
+
+  // enqueue() 가 쌓아 둔 프레임을 ring 스레드가 가져가 iovec 으로 구성
+  bool take_pending() {
+    {
+      std::lock_guard<std::mutex> lk(out_mx_);
+      dirty_ = false;
+      if (out_.take(inflight_, kMaxIov) == 0) return false;
+    }
+    iov_.clear();
+    for (auto& it : inflight_) {
+      std::string_view b = it.frame->tcp_bytes();
+      iov_.push_back(iovec{const_cast<char*>(b.data()), b.size()});
+    }
+    iov_pos_ = 0;
+    return true;
+  }
+
+  // SENDMSG 완료 바이트만큼 iovec 을 전진. 남은 게 없으면 false
+  bool advance(size_t n) {
+    while (n > 0 && iov_pos_ < iov_.size()) {
+      iovec& v = iov_[iov_pos_];
+      if (n < v.iov_len) {
+        v.iov_base = static_cast<char*>(v.iov_base) + n;
+        v.iov_len -= n;
+        return true;
+      }
+      n -= v.iov_len;
+      iov_pos_++;
+    }
+    if (iov_pos_ < iov_.size()) return true;
+    inflight_.clear();
+    iov_.clear();
+    return false;
+  }
+
+  int fd_;
+  uint32_t slot_;
+
+  // ring 스레드 전용 상태
+  framing::FrameDecoder decoder_;
+  std::deque<core::OutboundQueue::Item> inflight_; // 커널에 넘어간 프레임 (완료 전까지 유지)
+  std::vector<iovec> iov_;
+  size_t iov_pos_ = 0;
+  msghdr mh_{};
+  bool recv_armed_ = false;
+  bool send_armed_ = false;
+  bool disconnected_ = false;
+  std::weak_ptr<UringConnection> self_;
+
+private:
+  std::string id_;
+  DirtyList* dirty_list_;
+  std::atomic<bool> closed_{false};
+
+  std::mutex out_mx_;
+  core::OutboundQueue out_;
+  bool dirty_ = false;
+};
+
+} // namespace
+
+struct UringServer::Impl {
+  std::shared_ptr<core::ChatCore> core;
+  UringServerOptions opt;
+  std::atomic<bool>* running = nullptr;
+  core::OutboundStats* stats = nullptr;
+
+  Ring ring;
+  int listen_fd = -1;
+  int wake_fd = -1;
+  uint64_t wake_val = 0;
+  __kernel_timespec accept_retry_ts{};
+  bool fixed_bufs = false;
+  // SQ 가 꽉 차서 못 건 accept/wake. 다음 제출 뒤에 다시 시도
+  bool accept_unarmed = false;
+  bool wake_unarmed = false;
+  std::thread th;
+
+  std::vector<uint8_t> buf_pool;   // max_conns * recv_buf
+  std::vector<std::shared_ptr<UringConnection>> slots;
+  std::vector<uint32_t> free_slots;
+
+  DirtyList dirty;
+
+  Impl(std::shared_ptr<core::ChatCore> c, UringServerOptions o, std::atomic<bool>* r)
+    : core(std::move(c)), opt(o), running(r) {}
+
+  uint8_t* buf_of(uint32_t slot) { return buf_pool.data() + slot * opt.recv_buf; }
+
+  void arm_accept() {
+    io_uring_sqe* sqe = ring.get_sqe();
+    accept_unarmed = !sqe;
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = pack(OP_ACCEPT, 0);
+  }
+
+  // accept 실패 뒤 잠시 쉬었다가 다시 accept (바로 다시 걸면 같은 에러로 ring 이 돎)
+  void arm_accept_retry() {
+    io_uring_sqe* sqe = ring.get_sqe();
+    accept_unarmed = !sqe;
+    if (!sqe) return;
+    accept_retry_ts.tv_sec = 0;
+    accept_retry_ts.tv_nsec = kAcceptRetryNs;
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = reinterpret_cast<uint64_t>(&accept_retry_ts);
+    sqe->len = 1;
+    sqe->user_data = pack(OP_ACCEPT_RETRY, 0);
+  }
+
+  void arm_wake() {
+    io_uring_sqe* sqe = ring.get_sqe();
+    wake_unarmed = !sqe;
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wake_fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&wake_val);
+    sqe->len = sizeof(wake_val);
+    sqe->user_data = pack(OP_WAKE, 0);
+  }
+
+  void arm_recv(UringConnection& c) {
+    io_uring_sqe* sqe = ring.get_sqe();
+    if (!sqe) {
+      // recv 가 없으면 완료도 오지 않음 -> 여기서 바로 정리
+      disconnect(c);
+      maybe_release(c.slot_);
+      return;
+    }
+    if (fixed_bufs) {
+      sqe->opcode = IORING_OP_READ_FIXED;
+      sqe->buf_index = static_cast<uint16_t>(c.slot_);
+    } else {
+      sqe->opcode = IORING_OP_RECV;
+    }
+    sqe->fd = c.fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(buf_of(c.slot_));
+    sqe->len = static_cast<uint32_t>(opt.recv_buf);
+    sqe->user_data = pack(OP_RECV, c.slot_);
+    c.recv_armed_ = true;
+  }
+
+  void arm_send(UringConnection& c) {
+    io_uring_sqe* sqe = ring.get_sqe();
+    if (!sqe) {
+      disconnect(c);
+      maybe_release(c.slot_);
+      return;
+    }
+    c.mh_ = msghdr{};
+    c.mh_.msg_iov = c.iov_.data() + c.iov_pos_;
+    c.mh_.msg_iovlen = c.iov_.size() - c.iov_pos_;
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = c.fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&c.mh_);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = pack(OP_SEND, c.slot_);
+    c.send_armed_ = true;
+  }
+
+  // 연결당 in-flight SENDMSG 는 최대 1개. 그동안 쌓인 프레임은 다음 SQE 한 번으로 묶여 나감
+  void start_send_if_idle(UringConnection& c) {
+    if (c.send_armed_ || c.disconnected_) return;
+    if (c.take_pending()) arm_send(c);
+  }
+
+  void flush_dirty() {
+    std::vector<std::shared_ptr<UringConnection>> list;
+    {
+      std::lock_guard<std::mutex> lk(dirty.mx);
+      list.swap(dirty.list);
+    }
+    for (auto& c : list) {
+      if (slots[c->slot_] != c) continue; // 이미 정리된 연결
+      start_send_if_idle(*c);
+    }
+  }
+
+  void on_accept(int res) {
+    if (res >= 0) {
+      if (free_slots.empty()) {
+        ::close(res); // 슬롯(등록 버퍼) 소진
+      } else {
+        uint32_t slot = free_slots.back();
+        free_slots.pop_back();
+
+        std::ostringstream oss;
+        oss << "tcp:" << static_cast<std::uintptr_t>(res);
+        auto conn = std::make_shared<UringConnection>(res, slot, oss.str(), &dirty,
+                                                      &opt.outbound, stats);
+        conn->self_ = conn;
+        slots[slot] = conn;
+        core->on_connect(conn);
+        arm_recv(*conn);
+      }
+    }
+    if (!running->load()) return;
+    if (res < 0 && res != -EAGAIN && res != -EINTR && res != -ECONNABORTED) {
+      arm_accept_retry();
+    } else {
+      arm_accept();
+    }
+  }
+
+  void on_recv(uint32_t slot, int res) {
+    auto conn = slots[slot];
+    if (!conn) return;
+    conn->recv_armed_ = false;
+
+    bool eof = res <= 0 || conn->disconnected_;
+    if (!eof) {
+      conn->decoder_.append(buf_of(slot), static_cast<size_t>(res));
+
+      std::string_view payload;
+      while (!conn->closed() && conn->decoder_.next(payload)) {
+        if (!core->on_frame(conn, payload)) {
+          eof = true;
+          break;
+        }
+      }
+      if (conn->decoder_.error()) eof = true;
+    }
+
+    if (eof || conn->closed()) {
+      disconnect(*conn);
+    } else {
+      arm_recv(*conn);
+    }
+    maybe_release(slot);
+  }
+
+  void on_send(uint32_t slot, int res) {
+    auto conn = slots[slot];
+    if (!conn) return;
+    conn->send_armed_ = false;
+
+    if (res <= 0) {
+      disconnect(*conn);
+    } else {
+      if (conn->advance(static_cast<size_t>(res))) {
+        arm_send(*conn);
+      } else {
+        start_send_if_idle(*conn);
+      }
+    }
+    maybe_release(slot);
+  }
+
+  void disconnect(UringConnection& c) {
+    if (c.disconnected_) return;
+    c.disconnected_ = true;
+    c.close(); // shutdown -> 걸려 있는 recv/send 가 완료로 돌아옴
+    core->on_disconnect(slots[c.slot_]);
+  }
+
+  // 커널이 더 이상 버퍼/fd 를 참조하지 않을 때만 슬롯 반환
+  void maybe_release(uint32_t slot) {
+    auto& c = slots[slot];
+    if (!c || !c->disconnected_) return;
+    if (c->recv_armed_ || c->send_armed_) return;
+    ::close(c->fd_);
+    c.reset();
+    free_slots.push_back(slot);
+  }
+
+  void run() {
+    dirty.ring_tid = std::this_thread::get_id();
+    arm_wake();
+    arm_accept();
+
+    while (running->load()) {
+      int r = ring.submit(1);
+      if (r < 0) {
+        std::cerr << "io_uring_enter failed: " << net::last_error_string() << "\n";
+        break;
+      }
+
+      unsigned head = *ring.cq_head;
+      unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+      while (head != tail) {
+        io_uring_cqe& cqe = ring.cqes[head & ring.cq_mask];
+        Op op = static_cast<Op>(cqe.user_data & 0xff);
+        uint32_t slot = static_cast<uint32_t>(cqe.user_data >> 8);
+        int res = cqe.res;
+        head++;
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+
+        switch (op) {
+          case OP_ACCEPT: on_accept(res); break;
+          case OP_RECV: on_recv(slot, res); break;
+          case OP_SEND: on_send(slot, res); break;
+          case OP_WAKE:
+            if (running->load()) arm_wake();
+            break;
+          case OP_ACCEPT_RETRY:
+            if (running->load()) arm_accept();
+            break;
+        }
+        tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+      }
+
+      // 이번 배치에서 생긴 send 들을 모아 다음 enter 에 함께 제출
+      flush_dirty();
+      if (accept_unarmed) arm_accept();
+      if (wake_unarmed) arm_wake();
+    }
+  }
+
+  void shutdown_all() {
+    // ring 을 먼저 닫아야 커널이 버퍼를 놓음
+    ring.destroy();
+    for (auto& c : slots) {
+      if (!c) continue;
+      if (!c->disconnected_) {
+        c->close();
+        core->on_disconnect(c);
+      }
+      ::close(c->fd_);
+      c.reset();
+    }
+    if (wake_fd >= 0) ::close(wake_fd);
+    if (listen_fd >= 0) ::close(listen_fd);
+    wake_fd = listen_fd = -1;
+  }
+};
+
+bool UringConnection::enqueue(const core::FramePtr& frame, core::MsgClass cls) {
+  core::FramePtr f = core::Frame::as(frame, encoding());
+  if (core::Compression* z = compression()) f = core::Frame::compressed(f, *z);
+  if (f->payload_size() > kMaxFrame) return false;
+  if (closed_.load()) return false;
+
+  bool first = false;
+  {
+    std::lock_guard<std::mutex> lk(out_mx_);
+    auto r = out_.push(std::move(f), cls);
+    if (r == core::OutboundQueue::Push::Overflow) {
+      close();
+      return false;
+    }
+    if (r == core::OutboundQueue::Push::Queued && !dirty_) {
+      dirty_ = true;
+      first = true;
+    }
+  }
+  if (first) {
+    if (auto self = self_.lock()) dirty_list_->push(std::move(self));
+  }
+  return true;
+}
+
+UringServer::UringServer(std::shared_ptr<core::ChatCore> core, UringServerOptions opt)
+  : core_(std::move(core)), opt_(opt) {}
+
+UringServer::~UringServer() {
+  stop();
+}
+
+bool UringServer::supported() {
+  Ring r;
+  if (!r.init(8)) return false;
+
+  // 필요한 opcode 지원 여부 확인
+  size_t sz = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+  std::vector<uint8_t> mem(sz, 0);
+  auto* probe = reinterpret_cast<io_uring_probe*>(mem.data());
+  bool ok = sys_register(r.fd, IORING_REGISTER_PROBE, probe, 256) >= 0;
+  if (ok) {
+    for (int op : {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SENDMSG, IORING_OP_READ,
+                   IORING_OP_READ_FIXED, IORING_OP_TIMEOUT}) {
+      if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) ok = false;
+    }
+  }
+  r.destroy();
+  return ok;
+}
+
+bool UringServer::start(int port) {
+  if (running_) return false;
+  if (!core_) return false;
+  if (!supported()) {
+    std::cerr << "io_uring not supported by this kernel\n";
+    return false;
+  }
+
+  impl_ = std::make_unique<Impl>(core_, opt_, &running_);
+  Impl& im = *impl_;
+  im.stats = &out_stats_;
+
+  if (!im.ring.init(opt_.entries)) {
+    std::cerr << "io_uring_setup failed: " << net::last_error_string() << "\n";
+    impl_.reset();
+    return false;
+  }
+
+  im.listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  int one = 1;
+  setsockopt(im.listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  int backlog = opt_.backlog > 0 ? opt_.backlog : SOMAXCONN;
+  if (im.listen_fd < 0 ||
+      ::bind(im.listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(im.listen_fd, backlog) != 0) {
+    std::cerr << "listen failed: " << net::last_error_string() << "\n";
+    im.shutdown_all();
+    impl_.reset();
+    return false;
+  }
+
+  im.wake_fd = ::eventfd(0, EFD_CLOEXEC);
+  im.dirty.wake_fd = im.wake_fd;
+  if (im.wake_fd < 0) {
+    im.shutdown_all();
+    impl_.reset();
+    return false;
+  }
+
+  im.buf_pool.resize(static_cast<size_t>(opt_.max_conns) * opt_.recv_buf);
+  im.slots.resize(opt_.max_conns);
+  for (uint32_t i = opt_.max_conns; i > 0; i--) im.free_slots.push_back(i - 1);
+
+  std::vector<iovec> iov(opt_.max_conns);
+  for (uint32_t i = 0; i < opt_.max_conns; i++) {
+    iov[i].iov_base = im.buf_of(i);
+    iov[i].iov_len = opt_.recv_buf;
+  }
+  im.fixed_bufs = sys_register(im.ring.fd, IORING_REGISTER_BUFFERS, iov.data(),
+                               static_cast<unsigned>(iov.size())) == 0;
+  if (!im.fixed_bufs) {
+    // RLIMIT_MEMLOCK 등으로 등록 실패 -> 일반 RECV 로 동작
+    std::cerr << "io_uring buffer registration failed (" << net::last_error_string()
+              << "), using plain recv\n";
+  }
+
+  running_ = true;
+  im.th = std::thread([&im]() { im.run(); });
+
+  std::cout << "TCP server listening on " << port << " (io_uring"
+            << (im.fixed_bufs ? ", registered buffers" : "") << ")\n";
+  return true;
+}
+
+void UringServer::stop() {
+  if (!running_) return;
+  running_ = false;
+
+  if (impl_) {
+    uint64_t one = 1;
+    (void)!::write(impl_->wake_fd, &one, sizeof(one));
+    if (impl_->th.joinable()) impl_->th.join();
+    impl_->shutdown_all();
+    impl_.reset();
+  }
+}
+
+} // namespace transport::uring
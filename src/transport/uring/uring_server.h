@@ -0,0 +1,47 @@
+#pragma once
+#include <memory>
+#include <atomic>
+#include <cstddef>
+
+#include "core/chat_core.h"
+#include "core/outbound_queue.h"
+
+namespace transport::uring {
+
+struct UringServerOptions {
+  unsigned entries = 4096;        // SQ 크기
+  unsigned max_conns = 1024;      // 동시 연결 상한 (= 등록 버퍼 슬롯 수)
+  size_t recv_buf = 16 * 1024;    // 연결당 등록(registered) 수신 버퍼 크기
+  int backlog = 0;                // listen() backlog (0 이하 = SOMAXCONN)
+  core::OutboundLimits outbound;  // 연결별 송신 큐 상한 / 느린 소비자 정책
+};
+
+// io_uring 기반 TCP 서버 (Linux 전용)
+// - accept/recv/send 를 SQE 로 모아 한 번의 io_uring_enter 로 제출
+// - 수신은 연결마다 등록된 고정 버퍼로 READ_FIXED (등록 실패 시 일반 RECV)
+// - 프레이밍/프로토콜은 TcpServer 와 동일 (core::Connection 으로 ChatCore 에 연결)
+class UringServer {
+public:
+  explicit UringServer(std::shared_ptr<core::ChatCore> core, UringServerOptions opt = {});
+  ~UringServer();
+
+  // 커널이 io_uring(필요 opcode 포함)을 지원하지 않으면 false -> 호출자가 TcpServer 로 대체
+  bool start(int port);
+  void stop();
+
+  static bool supported();
+
+  const core::OutboundStats& outbound_stats() const { return out_stats_; }
+
+private:
+  std::shared_ptr<core::ChatCore> core_;
+  UringServerOptions opt_;
+  core::OutboundStats out_stats_;
+  std::atomic<bool> running_{false};
+
+  // pimpl (cpp 에서만 커널 헤더 의존)
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace transport::uring
@@ -1,13 +1,19 @@
 #include "transport/ws/ws_server.h"
 
+#include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/asio.hpp>
+#include <boost/version.hpp>
 #include <boost/beast.hpp>
 #include <boost/beast/websocket.hpp>
 
+#include "common/frame_decoder.h"
 #include "core/connection.h"
 #include "core/protocol.h"
 
@@ -19,39 +25,292 @@ using nlohmann::json;
 
 namespace transport::ws {
 
+namespace {
+
+std::string endpoint_id(const tcp::socket& s) {
+  std::ostringstream oss;
+  beast::error_code ec;
+  auto ep = s.remote_endpoint(ec);
+  if (ec) return "ws:unknown";
+  oss << "ws:" << ep.address().to_string() << ":" << ep.port();
+  return oss.str();
+}
+
+} // namespace
+
+// WS 연결별 송신 큐 (두 모드 공용). core 는 어느 스레드에서든 push 하고 바로 돌아감
+// - 상한/느린 소비자 정책은 TCP reactor 와 같은 OutboundQueue (바이트 기준 high-water mark)
+// - writer 는 한 번에 하나: push 가 쉬고 있던 writer 를 깨울 때만 Idle 을 돌려줌
+// - next: batch 를 받는 연결이면 큐에 이어서 쌓인 chat 들을 batch 프레임 하나로 합침
+//         (이미 batch 인 프레임, MessagePack 프레임은 그대로)
+class WsOutbox {
+public:
+  enum class Push { Idle, Busy, Closed };
+
+  WsOutbox(const core::OutboundLimits* limits, core::OutboundStats* stats)
+      : q_(limits, stats), stats_(stats) {}
+
+  // Closed = 이미 닫혔거나 정책상 끊어야 함 (Overflow 면 여기서 닫힘)
+  Push push(core::FramePtr f, core::MsgClass cls) {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (closed_) return Push::Closed;
+    switch (q_.push(std::move(f), cls)) {
+      case core::OutboundQueue::Push::Overflow:
+        closed_ = true;
+        q_.clear();
+        return Push::Closed;
+      case core::OutboundQueue::Push::Dropped:
+        return Push::Busy;
+      case core::OutboundQueue::Push::Queued:
+        break;
+    }
+    if (writing_) return Push::Busy;
+    writing_ = true;
+    cv_.notify_one();
+    return Push::Idle;
+  }
+
+  // 다음에 보낼 프레임. 없으면 nullptr 이고 writer 는 쉼 상태가 됨
+  core::FramePtr next(bool batch_rx) {
+    std::lock_guard<std::mutex> lk(mx_);
+    return next_locked(batch_rx);
+  }
+
+  // threaded 모드 writer 스레드용: 보낼 게 생길 때까지 기다림 (닫히면 nullptr)
+  // ping 요청이 있으면 ping = true 로 먼저 돌려줌
+  core::FramePtr wait_next(bool batch_rx, bool& ping) {
+    std::unique_lock<std::mutex> lk(mx_);
+    for (;;) {
+      if (ping_ && !closed_) {
+        ping_ = false;
+        ping = true;
+        writing_ = true;
+        return nullptr;
+      }
+      if (core::FramePtr f = next_locked(batch_rx)) return f;
+      if (closed_) return nullptr;
+      // next_locked 가 writing_ 을 내렸으므로 다음 push 가 깨움
+      cv_.wait(lk, [&] { return closed_ || ping_ || !q_.empty(); });
+    }
+  }
+
+  // threaded 모드: writer 스레드에게 ping 프레임을 보내게 함
+  void request_ping() {
+    std::lock_guard<std::mutex> lk(mx_);
+    if (closed_) return;
+    ping_ = true;
+    cv_.notify_one();
+  }
+
+  // 반환: 닫는 시점에 write 가 진행 중이었는지 (막혀 있을 수 있음)
+  bool close() {
+    std::lock_guard<std::mutex> lk(mx_);
+    closed_ = true;
+    q_.clear();
+    cv_.notify_one();
+    return writing_;
+  }
+
+private:
+  static constexpr size_t kCoalesceMax = 64;              // batch 하나에 합칠 최대 chat 수
+  static constexpr size_t kCoalesceBytes = 64 * 1024;     // 합친 payload 상한
+
+  static bool coalescable(const core::OutboundQueue::Item& it) {
+    return it.cls == core::MsgClass::Chat && it.frame->encoding() == core::Encoding::Json &&
+           !it.frame->is_batch() && !it.frame->is_compressed();
+  }
+
+  core::FramePtr next_locked(bool batch_rx) {
+    if (closed_ || q_.empty()) {
+      writing_ = false;
+      return nullptr;
+    }
+    writing_ = true;
+    auto& items = q_.items();
+    if (!batch_rx || !coalescable(items.front()) || items.size() < 2 ||
+        !coalescable(items[1])) {
+      taken_.clear();
+      q_.take(taken_, 1);
+      return std::move(taken_.front().frame);
+    }
+
+    size_t bytes = 0;
+    taken_.clear();
+    while (!items.empty() && taken_.size() < kCoalesceMax && coalescable(items.front()) &&
+           bytes + items.front().frame->payload_size() <= kCoalesceBytes) {
+      bytes += items.front().frame->payload_size();
+      q_.take(taken_, 1);
+    }
+    frames_.clear();
+    for (auto& it : taken_) frames_.push_back(std::move(it.frame));
+    core::FramePtr b = frames_.size() > 1 ? core::Frame::batch(frames_) : frames_.front();
+    if (frames_.size() > 1) stats_->coalesced.fetch_add(frames_.size(), std::memory_order_relaxed);
+    return b;
+  }
+
+  std::mutex mx_;
+  std::condition_variable cv_;
+  core::OutboundQueue q_;
+  core::OutboundStats* stats_;
+  bool writing_ = false;
+  bool closed_ = false;
+  bool ping_ = false;
+  std::deque<core::OutboundQueue::Item> taken_; // next 용 임시 (재사용)
+  std::vector<core::FramePtr> frames_;
+};
+
+// threaded 모드 연결: 읽기는 연결 스레드가 블로킹으로, 쓰기는 연결별 writer 스레드가
+// WsOutbox 를 비우며 블로킹 write (core 쪽 호출자는 큐에 넣고 바로 돌아감)
 class WsConnection : public core::Connection {
 public:
-  explicit WsConnection(std::shared_ptr<websocket::stream<tcp::socket>> ws, std::string id)
-      : ws_(std::move(ws)), id_(std::move(id)) {}
+  WsConnection(std::shared_ptr<websocket::stream<tcp::socket>> ws, std::string id,
+               const core::OutboundLimits* limits, core::OutboundStats* stats)
+      : ws_(std::move(ws)), id_(std::move(id)), out_(limits, stats) {
+    writer_ = std::thread([this] { write_loop(); });
+  }
+
+  ~WsConnection() override {
+    out_.close();
+    if (writer_.joinable()) writer_.join();
+  }
+
+  using core::Connection::enqueue;
 
   bool send(const json& j) override {
-    try {
-      std::lock_guard<std::mutex> lk(write_mx_);
-      if (!ws_ || !ws_->is_open()) return false;
-      ws_->text(true);
-      ws_->write(asio::buffer(j.dump()));
-      return true;
-    } catch (...) {
-      return false;
+    return enqueue(j, core::MsgClass::System);
+  }
+
+  // 공유 프레임의 payload 를 그대로 전송 (JSON = 텍스트 프레임, MessagePack = 바이너리 프레임)
+  bool enqueue(const core::FramePtr& frame, core::MsgClass cls) override {
+    return out_.push(core::Frame::as(frame, encoding()), cls) != WsOutbox::Push::Closed;
+  }
+
+  // Keepalive: 소켓은 writer 스레드만 쓰므로 ping 프레임도 writer 가 보냄
+  void ping() override { out_.request_ping(); }
+
+  // 소켓을 shutdown 해서 막힌 read/write 를 깨움 (close 프레임 없이)
+  // close 핸드셰이크는 응답을 읽어야 하는데 읽기는 연결 스레드가 쥐고 있어서 하지 않음
+  void close() override {
+    out_.close();
+    beast::error_code ec;
+    ws_->next_layer().shutdown(tcp::socket::shutdown_both, ec);
+  }
+
+  // 읽기 루프가 끝난 뒤 close() 다음에: writer 가 끝나기를 기다림
+  void join_writer() {
+    if (writer_.joinable()) writer_.join();
+  }
+
+  std::string id() const override { return id_; }
+
+private:
+  void write_loop() {
+    for (;;) {
+      bool ping = false;
+      core::FramePtr f = out_.wait_next(batch_rx(), ping);
+      beast::error_code ec;
+      if (ping) {
+        ws_->ping({}, ec);
+      } else if (!f) {
+        break;
+      } else {
+        std::string_view t = f->text();
+        ws_->text(f->encoding() == core::Encoding::Json);
+        ws_->write(asio::buffer(t.data(), t.size()), ec);
+      }
+      if (ec) {
+        out_.close();
+        break;
+      }
     }
   }
 
+  std::shared_ptr<websocket::stream<tcp::socket>> ws_;
+  std::string id_;
+  WsOutbox out_;
+  std::thread writer_;
+};
+
+// async 모드 연결 (소유 io_context 스레드에서만 소켓을 만짐)
+// - read: async_read 를 하나씩 이어서 걸어 둠. 유휴 연결은 스레드도 큰 버퍼도 쓰지 않음
+// - enqueue: 어느 스레드에서 호출돼도 됨. WsOutbox 에 넣고 writer 가 쉬고 있을 때만 post
+//            async_write 는 한 번에 하나 (Beast 제약), 완료 핸들러가 다음 프레임을 이어서 보냄
+// - close: io_context 로 post 해서 async_close (write 가 막혀 있으면 소켓을 닫음)
+//          read 가 끝나면 on_disconnect
+class WsSession : public core::Connection, public std::enable_shared_from_this<WsSession> {
+public:
+  WsSession(tcp::socket sock, WsServer::Impl* owner, const core::OutboundLimits* limits,
+            core::OutboundStats* stats)
+      : id_(endpoint_id(sock)), ws_(std::move(sock)), owner_(owner), out_(limits, stats) {}
+
+  using core::Connection::enqueue;
+
+  bool send(const json& j) override {
+    return enqueue(j, core::MsgClass::System);
+  }
+
+  bool enqueue(const core::FramePtr& frame, core::MsgClass cls) override {
+    switch (out_.push(core::Frame::as(frame, encoding()), cls)) {
+      case WsOutbox::Push::Closed:
+        return false;
+      case WsOutbox::Push::Idle:
+        asio::post(ws_.get_executor(), [self = shared_from_this()] { self->do_write(); });
+        break;
+      case WsOutbox::Push::Busy:
+        break;
+    }
+    return true;
+  }
+
   void close() override {
-    try {
-      std::lock_guard<std::mutex> lk(write_mx_);
-      if (ws_ && ws_->is_open()) {
+    if (close_posted_.exchange(true)) return;
+    bool stalled = out_.close();
+    asio::post(ws_.get_executor(), [self = shared_from_this(), stalled] {
+      if (stalled) {
         beast::error_code ec;
-        ws_->close(websocket::close_code::normal, ec);
+        beast::get_lowest_layer(self->ws_).close(ec);
+        return;
       }
-    } catch (...) {}
+      // 상대가 close 응답을 주지 않으면(죽은 연결) 오래 붙잡지 않게 잠시 뒤 소켓을 닫음
+      auto guard = std::make_shared<asio::steady_timer>(self->ws_.get_executor(),
+                                                        std::chrono::seconds(1));
+      guard->async_wait([self, guard](beast::error_code ec) {
+        if (ec) return;
+        beast::get_lowest_layer(self->ws_).close(ec);
+      });
+      self->ws_.async_close(websocket::close_code::normal,
+                            [guard](beast::error_code) { guard->cancel(); });
+    });
+  }
+
+  // Keepalive: ping 프레임 (진행 중인 write 가 있으면 Beast 가 그 뒤로 미룸)
+  void ping() override {
+    asio::post(ws_.get_executor(), [self = shared_from_this()] {
+      if (self->done_ || self->close_posted_) return;
+      self->ws_.async_ping({}, [self](beast::error_code) {});
+    });
   }
 
   std::string id() const override { return id_; }
 
+  void start();
+  // 서버 종료: io_context 가 멈춘 뒤 호출 (소켓을 닫고 core 에서 뺌)
+  void abort();
+
 private:
-  std::shared_ptr<websocket::stream<tcp::socket>> ws_;
+  void on_handshake(beast::error_code ec);
+  void do_read();
+  void on_read(beast::error_code ec);
+  void do_write();
+  void finish();
+
   std::string id_;
-  std::mutex write_mx_;
+  websocket::stream<tcp::socket> ws_;
+  beast::flat_buffer buf_;
+  WsServer::Impl* owner_;
+  std::atomic<bool> done_{false};        // on_disconnect 를 한 번만
+  std::atomic<bool> close_posted_{false};
+  WsOutbox out_;
 };
 
 struct WsServer::Impl {
@@ -60,11 +319,63 @@ struct WsServer::Impl {
   std::thread th;
   int port = 0;
 
+  // async 모드: io_context 마다 스레드 하나, 새 연결은 라운드로빈으로 배정
+  // acceptor 는 첫 io_context 에서 돔
+  std::vector<std::unique_ptr<asio::io_context>> iocs;
+  std::vector<asio::executor_work_guard<asio::io_context::executor_type>> guards;
+  std::vector<std::thread> threads;
+  size_t next_ioc = 0;
+  std::unique_ptr<tcp::acceptor> async_acceptor;
+  std::unique_ptr<asio::steady_timer> accept_backoff;
+  std::mutex sess_mx;
+  std::unordered_map<WsSession*, std::weak_ptr<WsSession>> sessions; // 종료 시 정리용
+
   std::shared_ptr<core::ChatCore> core;
+  WsServerOptions opt;
   std::atomic<bool>* running = nullptr;
+  core::OutboundStats* out_stats = nullptr;
+
+  Impl(std::shared_ptr<core::ChatCore> c, WsServerOptions o, std::atomic<bool>* r,
+       core::OutboundStats* st)
+      : core(std::move(c)), opt(o), running(r), out_stats(st) {}
+
+  void apply_deflate(websocket::stream<tcp::socket>& ws) const {
+    if (!opt.deflate) return;
+    websocket::permessage_deflate pmd;
+    pmd.server_enable = true;
+    pmd.compLevel = opt.deflate_level;
+#if BOOST_VERSION >= 107500
+    pmd.msg_size_threshold = opt.deflate_min;
+#endif
+    ws.set_option(pmd);
+  }
+
+  void do_accept() {
+    asio::io_context& target = *iocs[next_ioc++ % iocs.size()];
+    async_acceptor->async_accept(target, [this](beast::error_code ec, tcp::socket sock) {
+      if (!running->load()) return;
+      if (ec) {
+        // fd 고갈(EMFILE) 등: 잠깐 쉬었다가 다시 (바로 재시도하면 루프가 돎)
+        accept_backoff->expires_after(std::chrono::milliseconds(100));
+        accept_backoff->async_wait([this](beast::error_code) {
+          if (running->load()) do_accept();
+        });
+        return;
+      }
+      auto s = std::make_shared<WsSession>(std::move(sock), this, &opt.outbound, out_stats);
+      {
+        std::lock_guard<std::mutex> lk(sess_mx);
+        sessions.emplace(s.get(), s);
+      }
+      s->start();
+      do_accept();
+    });
+  }
 
-  explicit Impl(std::shared_ptr<core::ChatCore> c, std::atomic<bool>* r)
-      : core(std::move(c)), running(r) {}
+  void forget(WsSession* s) {
+    std::lock_guard<std::mutex> lk(sess_mx);
+    sessions.erase(s);
+  }
 
   void run_accept_loop() {
     while (running->load()) {
@@ -78,39 +389,36 @@ struct WsServer::Impl {
         try {
           auto ws = std::make_shared<websocket::stream<tcp::socket>>(std::move(client_sock));
           ws->set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+          apply_deflate(*ws);
           ws->accept(); // handshake
 
-          // 연결 ID
-          std::ostringstream oss;
-          try {
-            auto ep = ws->next_layer().socket().remote_endpoint();
-            oss << "ws:" << ep.address().to_string() << ":" << ep.port();
-          } catch (...) {
-            oss << "ws:unknown";
-          }
-
-          auto conn = std::make_shared<WsConnection>(ws, oss.str());
+          auto conn = std::make_shared<WsConnection>(ws, endpoint_id(ws->next_layer()),
+                                                     &opt.outbound, out_stats);
           core->on_connect(conn);
+          ws->control_callback([c = conn.get()](websocket::frame_type, beast::string_view) {
+            c->mark_rx();
+          });
 
+          // read 에러(끊김/close)는 예외 대신 ec 로 받아 아래 정리까지 가게 함
           beast::flat_buffer buffer;
           while (running->load() && ws->is_open()) {
             buffer.clear();
-            ws->read(buffer); // blocking
-
-            std::string payload = beast::buffers_to_string(buffer.data());
-            json j;
-            try {
-              j = json::parse(payload);
-            } catch (...) {
+            beast::error_code rec;
+            ws->read(buffer, rec); // blocking
+            if (rec) break;
+
+            // flat_buffer 는 연속 메모리 -> 복사 없이 view 로 디코딩
+            auto data = buffer.data();
+            std::string_view payload(static_cast<const char*>(data.data()), data.size());
+            if (!core->on_frame(conn, payload)) {
               conn->send(core::proto::make_error("", "BAD_JSON", "invalid json"));
-              continue;
             }
-
-            core->on_message(conn, j);
           }
 
+          ws->control_callback();
           core->on_disconnect(conn);
           conn->close();
+          conn->join_writer();
         } catch (...) {
           // handshake/read 예외면 그냥 종료
         }
@@ -119,8 +427,80 @@ struct WsServer::Impl {
   }
 };
 
-WsServer::WsServer(std::shared_ptr<core::ChatCore> core)
-    : core_(std::move(core)) {}
+void WsSession::start() {
+  ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+  ws_.read_message_max(framing::kMaxFrameSize);
+  // pong(및 클라이언트 ping)도 수신으로 침: keepalive 가 보는 시각 (세션이 stream 을 소유)
+  ws_.control_callback([this](websocket::frame_type, beast::string_view) { mark_rx(); });
+  owner_->apply_deflate(ws_);
+  ws_.async_accept([self = shared_from_this()](beast::error_code ec) { self->on_handshake(ec); });
+}
+
+void WsSession::on_handshake(beast::error_code ec) {
+  if (ec) {
+    // core 에 등록하기 전이라 목록에서만 뺌
+    done_ = true;
+    owner_->forget(this);
+    return;
+  }
+  owner_->core->on_connect(shared_from_this());
+  do_read();
+}
+
+void WsSession::do_read() {
+  ws_.async_read(buf_, [self = shared_from_this()](beast::error_code ec, size_t) {
+    self->on_read(ec);
+  });
+}
+
+void WsSession::on_read(beast::error_code ec) {
+  if (ec) {
+    finish();
+    return;
+  }
+  // flat_buffer 는 연속 메모리 -> 복사 없이 view 로 디코딩
+  auto data = buf_.data();
+  std::string_view payload(static_cast<const char*>(data.data()), data.size());
+  if (!owner_->core->on_frame(shared_from_this(), payload)) {
+    send(core::proto::make_error("", "BAD_JSON", "invalid json"));
+  }
+  buf_.consume(buf_.size());
+  // 큰 메시지 한 번에 늘어난 버퍼를 유휴 연결이 계속 쥐고 있지 않게
+  if (buf_.capacity() > 64 * 1024) buf_.shrink_to_fit();
+  do_read();
+}
+
+void WsSession::do_write() {
+  core::FramePtr f = out_.next(batch_rx());
+  if (!f) return;
+  std::string_view t = f->text();
+  ws_.text(f->encoding() == core::Encoding::Json);
+  ws_.async_write(asio::buffer(t.data(), t.size()),
+                  [self = shared_from_this(), f](beast::error_code ec, size_t) {
+                    if (ec) {
+                      // 읽기 쪽이 곧 실패하며 정리함. 남은 프레임은 버림
+                      self->out_.close();
+                      return;
+                    }
+                    self->do_write();
+                  });
+}
+
+void WsSession::finish() {
+  if (done_.exchange(true)) return;
+  out_.close();
+  owner_->forget(this);
+  owner_->core->on_disconnect(shared_from_this());
+}
+
+void WsSession::abort() {
+  beast::error_code ec;
+  ws_.next_layer().close(ec);
+  finish();
+}
+
+WsServer::WsServer(std::shared_ptr<core::ChatCore> core, WsServerOptions opt)
+    : core_(std::move(core)), opt_(opt) {}
 
 WsServer::~WsServer() { stop(); }
 
@@ -128,8 +508,9 @@ bool WsServer::start(int port) {
   if (running_) return false;
   if (!core_) return false;
 
-  impl_ = std::make_unique<Impl>(core_, &running_);
+  impl_ = std::make_unique<Impl>(core_, opt_, &running_, &out_stats_);
   impl_->port = port;
+  if (opt_.mode == WsMode::Async) return start_async(port);
 
   beast::error_code ec;
   tcp::endpoint ep{tcp::v4(), static_cast<unsigned short>(port)};
@@ -152,12 +533,72 @@ bool WsServer::start(int port) {
   return true;
 }
 
+bool WsServer::start_async(int port) {
+  Impl& im = *impl_;
+  int n = opt_.io_threads > 0 ? opt_.io_threads
+                              : static_cast<int>(std::thread::hardware_concurrency());
+  if (n <= 0) n = 1;
+  for (int i = 0; i < n; i++) {
+    im.iocs.push_back(std::make_unique<asio::io_context>(1));
+    im.guards.push_back(asio::make_work_guard(*im.iocs.back()));
+  }
+
+  beast::error_code ec;
+  tcp::endpoint ep{tcp::v4(), static_cast<unsigned short>(port)};
+  im.async_acceptor = std::make_unique<tcp::acceptor>(*im.iocs[0]);
+  im.accept_backoff = std::make_unique<asio::steady_timer>(*im.iocs[0]);
+  im.async_acceptor->open(ep.protocol(), ec);
+  if (ec) return false;
+  im.async_acceptor->set_option(asio::socket_base::reuse_address(true), ec);
+  if (ec) return false;
+  im.async_acceptor->bind(ep, ec);
+  if (ec) return false;
+  im.async_acceptor->listen(asio::socket_base::max_listen_connections, ec);
+  if (ec) return false;
+
+  running_ = true;
+  im.do_accept();
+  for (auto& ioc : im.iocs) {
+    im.threads.emplace_back([&ioc] { ioc->run(); });
+  }
+
+  std::cout << "WS server listening on " << port << " (async, " << n << " io threads)\n";
+  return true;
+}
+
 void WsServer::stop() {
   if (!running_) return;
   running_ = false;
 
+  if (impl_ && opt_.mode == WsMode::Async) {
+    Impl& im = *impl_;
+    for (auto& ioc : im.iocs) ioc->stop();
+    for (auto& t : im.threads) {
+      if (t.joinable()) t.join();
+    }
+    // 루프가 멈춘 뒤 남은 연결을 core 에서 빼고 소켓을 닫음
+    std::vector<std::shared_ptr<WsSession>> live;
+    {
+      std::lock_guard<std::mutex> lk(im.sess_mx);
+      for (auto& [_, w] : im.sessions) {
+        if (auto sp = w.lock()) live.push_back(std::move(sp));
+      }
+    }
+    for (auto& sess : live) sess->abort();
+    live.clear();
+    beast::error_code ec;
+    im.async_acceptor->close(ec);
+    im.guards.clear();
+    impl_.reset();
+    return;
+  }
+
   if (impl_) {
     beast::error_code ec;
+#ifndef _WIN32
+    // 막혀 있는 accept 를 깨움 (Linux 는 close 만으로는 깨지 않음)
+    ::shutdown(impl_->acceptor.native_handle(), SHUT_RDWR);
+#endif
     impl_->acceptor.close(ec);
     if (impl_->th.joinable()) impl_->th.join();
     impl_.reset();
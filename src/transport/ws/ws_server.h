@@ -7,19 +7,47 @@
 
 namespace transport::ws {
 
+class WsSession;
+
+// Threaded: 연결당 스레드 2개 (블로킹 read + 송신 큐 writer, 연결 수 x 2 = 스레드 수). 비교용
+// Async   : io_context N개(코어당 하나, 각자 스레드 1개)에 연결을 나눠 담고
+//           handshake/read/write 를 모두 비동기로 -> 연결 수가 스레드 수와 무관 (기본)
+enum class WsMode { Threaded, Async };
+
+struct WsServerOptions {
+  WsMode mode = WsMode::Async;
+  int io_threads = 0; // Async: io_context(=스레드) 수 (0 = 코어 수)
+
+  // permessage-deflate (RFC 7692) 를 클라이언트가 제안하면 수락
+  // 압축은 Beast 가 연결마다 함 (deflate 문맥이 연결별이라 수신자끼리 공유 불가)
+  bool deflate = false;
+  int deflate_level = 6;      // zlib 1..9
+  size_t deflate_min = 512;   // 이보다 작은 메시지는 압축하지 않음 (Boost 1.75+)
+
+  // 연결별 송신 큐 상한 / 느린 소비자 정책 (두 모드 모두, TCP reactor 와 같은 규칙)
+  core::OutboundLimits outbound;
+};
+
 class WsServer {
 public:
-  explicit WsServer(std::shared_ptr<core::ChatCore> core);
+  explicit WsServer(std::shared_ptr<core::ChatCore> core, WsServerOptions opt = {});
   ~WsServer();
 
   bool start(int port);
   void stop();
 
+  const core::OutboundStats& outbound_stats() const { return out_stats_; }
+
 private:
+  bool start_async(int port);
+
   std::shared_ptr<core::ChatCore> core_;
+  WsServerOptions opt_;
   std::atomic<bool> running_{false};
+  core::OutboundStats out_stats_;
 
   // pimpl-ish (cpp에서만 Boost 의존)
+  friend class WsSession;
   struct Impl;
   std::unique_ptr<Impl> impl_;
 };